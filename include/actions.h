@@ -0,0 +1,104 @@
+//動作表與派送
+//每個鍵位在每一層對應一個 16-bit 動作碼。預設表編譯時建好並放在 PROGMEM，
+//執行時使用 RAM 中的副本（可由主機修改，見 keymap_store.h；OHK_KEYMAP_EDIT=0 時直接查 PROGMEM），
+//按鍵事件只需查表一次即可決定要做什麼。
+//
+//  bit 15..12：動作類型（ActionType）
+//  bit 11..8 ：參數（修飾鍵遮罩 / 層操作）
+//  bit  7..0 ：鍵碼 / 滑鼠按鍵
+//
+//一般鍵的類型與參數皆為 0，因此 KEY_xxx 鍵碼本身就是合法的動作碼。
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+#include "progmem.h"
+
+typedef uint16_t action_t;
+
+enum ActionType : uint8_t {
+  ACT_KEY = 0x0,    //一般鍵（可帶修飾鍵）
+  ACT_LAYER = 0x1,  //層操作
+  ACT_MOUSE = 0x2,  //滑鼠按鍵
+  ACT_SYSTEM = 0x3, //韌體設定
+  ACT_MOD_TAP = 0x4,   //點按送鍵碼，按住為修飾鍵（參數為修飾鍵遮罩）
+  ACT_LAYER_TAP = 0x5, //點按送鍵碼，按住開啟層（參數為層）
+  ACT_MACRO = 0x6,     //播放巨集（鍵碼欄位為巨集編號，見 macros.h）
+  ACT_TRANSPARENT = 0xF, //透明：改用下面一層（見 layers.h）
+};
+
+//修飾鍵遮罩：第 i 位對應鍵碼 KEY_LEFT_CTRL + i
+#define MOD_CTRL  0x1
+#define MOD_SHIFT 0x2
+#define MOD_ALT   0x4
+#define MOD_GUI   0x8
+
+//層操作（鍵碼欄位為目標層）
+enum LayerOp : uint8_t {
+  LAYER_OP_MOMENTARY = 0,  //按住時開啟
+  LAYER_OP_TOGGLE = 1,     //按一下開啟 / 關閉
+  LAYER_OP_ONESHOT = 2,    //只對下一個按鍵有效（按住時同 MOMENTARY）
+  LAYER_OP_DEFAULT = 3,    //設為預設層
+};
+
+//韌體設定
+enum SystemOp : uint8_t {
+  SYS_NKRO_TOGGLE = 0,  //切換 NKRO / 6KRO 鍵盤模式
+};
+
+#define ACTION(type, param, code) \
+  ((action_t)(((uint16_t)(type) << 12) | ((uint16_t)(param) << 8) | (uint8_t)(code)))
+#define ACTION_TYPE(a)  ((uint8_t)((a) >> 12))
+#define ACTION_PARAM(a) ((uint8_t)(((a) >> 8) & 0x0F))
+#define ACTION_CODE(a)  ((uint8_t)(a))
+
+//鍵位表用的簡寫
+#define MK(mods, code) ACTION(ACT_KEY, mods, code)   //修飾鍵 + 鍵
+#define MO(layer)      ACTION(ACT_LAYER, LAYER_OP_MOMENTARY, layer)  //按住開啟層
+#define TG(layer)      ACTION(ACT_LAYER, LAYER_OP_TOGGLE, layer)     //切換層
+#define OSL(layer)     ACTION(ACT_LAYER, LAYER_OP_ONESHOT, layer)    //單次層
+#define DF(layer)      ACTION(ACT_LAYER, LAYER_OP_DEFAULT, layer)    //預設層
+#define TRNS           ACTION(ACT_TRANSPARENT, 0, 0)                 //透明
+#define MS(button)     ACTION(ACT_MOUSE, 0, button)  //滑鼠按鍵
+#define SYS(op)        ACTION(ACT_SYSTEM, 0, op)     //韌體設定
+#define MT(mods, code) ACTION(ACT_MOD_TAP, mods, code)     //點按為鍵、按住為修飾鍵
+#define LT(layer, code) ACTION(ACT_LAYER_TAP, layer, code) //點按為鍵、按住開啟層
+#define MACRO(n)       ACTION(ACT_MACRO, 0, n)       //巨集
+
+//點按 / 按住要等判定（見 taphold.h）的動作
+static inline bool actionIsTapHold(action_t action) {
+  const uint8_t type = ACTION_TYPE(action);
+  return type == ACT_MOD_TAP || type == ACT_LAYER_TAP;
+}
+
+//預設動作表（定義於 keymap.cpp）
+extern const action_t actionmaps[LAYER_COUNT][KEY_COUNT] PROGMEM;
+
+#if OHK_KEYMAP_EDIT
+//目前的動作表（定義於 keymap_store.cpp）
+extern action_t keymap[LAYER_COUNT][KEY_COUNT];
+
+static inline action_t actionAt(byte layer, byte keyID) {
+  return keymap[layer][keyID];
+}
+#else
+static inline action_t actionAt(byte layer, byte keyID) {
+  return pgmRead(&actionmaps[layer][keyID]);
+}
+#endif
+
+//處理一個按鍵事件：按下時依層堆疊查表，放開時依按下當時的層級查表。
+//timeMs 為實體按下 / 放開的時間，連同查到的層交給 keyboardRecord() 記錄
+void actionDispatch(byte keyID, bool pressed, uint32_t timeMs);
+
+//執行不屬於單一鍵位的動作（組合鍵觸發時使用，點按 / 按住鍵一律視為點按）
+void actionExecute(action_t action, bool pressed);
+
+//按下 / 放開單一鍵碼（巨集使用；修飾鍵與實體按鍵共用計數）
+void actionKey(uint8_t code, bool pressed);
+
+//點按 / 按住鍵判定後、派送按下之前呼叫：記住這次按下是按住（true）還是點按
+void actionSetHold(byte keyID, bool hold);
+
+//放開所有鍵（鍵位表整個換掉時使用）
+void actionReleaseAll();
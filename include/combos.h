@@ -0,0 +1,32 @@
+//組合鍵（combo）：幾個鍵在 COMBO_TERM_MS 內一起按下時改送另一個動作
+//組合以 56-bit 鍵位遮罩表示（與 matrix_t 同格式），開機時先算出所有組合用到的鍵，
+//不在任何組合裡的鍵只需一次位元運算就直接往下送，不會被延遲。
+#pragma once
+
+#include <Arduino.h>
+#include "actions.h"
+#include "layers.h"
+
+struct Combo {
+  uint64_t keys;        //第 keyID 位為 1 表示組合包含此鍵（最多 COMBO_MAX_KEYS 個）
+  layer_mask_t layers;  //在哪些層（目前層級）有效
+  action_t action;      //觸發時的動作（可以是任何動作碼）
+};
+
+#define COMBO_MAX_KEYS 4
+
+#define KEYBIT(k) ((uint64_t)1 << (k))
+#define COMBO2(a, b)    (KEYBIT(a) | KEYBIT(b))
+#define COMBO3(a, b, c) (KEYBIT(a) | KEYBIT(b) | KEYBIT(c))
+
+//組合表（定義於 keymap.cpp）
+extern const Combo combos[] PROGMEM;
+extern const uint8_t comboCount;
+
+void combosInit();
+
+//矩陣按鍵事件：不屬於組合的直接交給 tapHoldEvent，可能成為組合的先暫存
+void comboEvent(byte keyID, bool pressed, uint32_t nowMs);
+
+//每次迴圈呼叫：暫存超過 COMBO_TERM_MS 即判定
+void comboUpdate(uint32_t nowMs);
@@ -0,0 +1,117 @@
+//單手鍵盤硬體與鍵位常數
+//AVR: Pro Micro 開發板（ATmega32U4）
+#pragma once
+
+#include <Arduino.h>
+
+//旋鈕腳位定義
+#define DT_PIN 0
+#define CLK_PIN 1
+#define SW_PIN 15
+
+//特殊按鍵 ID
+#define FN_KEY_ID  40
+#define CTRL_KEY_ID 46
+#define LAYER_KEY_ID 47
+#define HASHTAG_KEY_ID 9
+#define AND_KEY_ID 10
+#define STAR_KEY_ID 11
+#define L_BRACKET_KEY_ID 2
+#define PLUS_KEY_ID 13
+#define CARET_KEY_ID 22
+#define R_BRACKET_KEY_ID 3
+#define SEMICOLON_KEY_ID 25
+#define QUOTE_KEY_ID 26
+#define COMMA_KEY_ID 27
+#define PERIOD_KEY_ID 28
+#define MOUSE_LEFT_KEY_ID 48
+#define MOUSE_RIGHT_KEY_ID 49
+
+//矩陣尺寸
+const byte ROWS = 7;
+const byte COLS = 8;
+const byte KEY_COUNT = ROWS * COLS;
+
+//旋鈕按鍵跟著矩陣一起掃描，放在矩陣之後的第 56 位
+const byte ENC_SW_KEY_ID = KEY_COUNT;
+const byte INPUT_COUNT = KEY_COUNT + 1;
+
+//防彈跳演算法（以 -DOHK_DEBOUNCE=... 選擇）
+#define DEBOUNCE_EAGER_PRESS 0  //按下立即回報，放開需穩定 DEBOUNCE_MS 才回報
+#define DEBOUNCE_SYM_DEFER   1  //按下 / 放開都需穩定 DEBOUNCE_MS 才回報
+#define DEBOUNCE_COUNTER     2  //積分計數器：以毫秒累積一致的讀值，累積到 DEBOUNCE_MS 才切換
+
+#ifndef OHK_DEBOUNCE
+#define OHK_DEBOUNCE DEBOUNCE_EAGER_PRESS
+#endif
+
+//防彈跳時間（毫秒，最大 127）
+#ifndef DEBOUNCE_MS
+#define DEBOUNCE_MS 5
+#endif
+
+//點按 / 按住鍵（MT、LT）的判定方式（以 -DOHK_TAP_HOLD=... 選擇）
+#define TAP_HOLD_TIMEOUT     0  //只看時間：按住超過 TAPPING_TERM_MS 才算按住
+#define TAP_HOLD_PERMISSIVE  1  //另外，期間有其他鍵按下並放開也算按住
+#define TAP_HOLD_OTHER_PRESS 2  //另外，期間有其他鍵按下就算按住
+
+#ifndef OHK_TAP_HOLD
+#define OHK_TAP_HOLD TAP_HOLD_OTHER_PRESS
+#endif
+
+//點按 / 按住的分界時間（毫秒）
+#ifndef TAPPING_TERM_MS
+#define TAPPING_TERM_MS 200
+#endif
+
+//同時按下視為組合鍵（combo）的時間窗（毫秒）
+#ifndef COMBO_TERM_MS
+#define COMBO_TERM_MS 40
+#endif
+
+//矩陣掃描 / 派送 / 回報的固定頻率（Hz，建議 1000 ~ 8000；低於 245 時 Timer3 不分頻會溢位）
+#ifndef SCAN_RATE_HZ
+#define SCAN_RATE_HZ 1000
+#endif
+
+//沒有輸入超過此時間（毫秒）就停止掃描並睡眠，有按鍵或旋鈕時立即恢復（見 power.h）；0 為不閒置
+//USB 被主機暫停（suspend）時不必等這段時間
+#ifndef IDLE_TIMEOUT_MS
+#define IDLE_TIMEOUT_MS 5000
+#endif
+
+//鬼鍵過濾（見 matrix.h）：矩陣中沒有逐鍵二極體時，矩形三個角按下會讓第四個角誤判為按下
+#ifndef OHK_GHOST_FILTER
+#define OHK_GHOST_FILTER 1
+#endif
+
+//鍵位表可否由主機修改（見 keymap_store.h）：1 時查 RAM 中的副本（佔 LAYER_COUNT x KEY_COUNT x 2 bytes），
+//0 時直接查 PROGMEM 中的預設表，主機只能讀取
+#ifndef OHK_KEYMAP_EDIT
+#define OHK_KEYMAP_EDIT 1
+#endif
+
+//開機時是否使用 NKRO 鍵盤（可用 FN+\ 切換）
+#ifndef OHK_NKRO_DEFAULT
+#define OHK_NKRO_DEFAULT 1
+#endif
+
+//旋鈕滾動加速（轉速單位：段/秒；倍率為 Q8 定點數，256 = 1 倍）
+#ifndef SCROLL_ACCEL_START
+#define SCROLL_ACCEL_START 6     //超過此轉速開始加速
+#endif
+#ifndef SCROLL_ACCEL_SLOPE
+#define SCROLL_ACCEL_SLOPE 64    //每多 1 段/秒增加的倍率（64 = 0.25 倍）
+#endif
+#ifndef SCROLL_ACCEL_MAX
+#define SCROLL_ACCEL_MAX 2560    //最大倍率（10 倍）
+#endif
+#ifndef SCROLL_FINE_SPEED
+#define SCROLL_FINE_SPEED 3      //高解析度模式下低於此轉速為微調
+#endif
+#ifndef SCROLL_FINE_GAIN
+#define SCROLL_FINE_GAIN 128     //微調倍率（0.5 倍，每段半格）
+#endif
+
+//層數（英文層、英文 FN 層、注音層、注音 FN 層）
+const byte LAYER_COUNT = 4;
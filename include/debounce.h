@@ -0,0 +1,11 @@
+//逐鍵防彈跳
+//對矩陣 56 鍵與旋鈕按鍵各自維護狀態，演算法由 OHK_DEBOUNCE 選擇（見 config.h）。
+#pragma once
+
+#include <Arduino.h>
+#include "matrix.h"
+
+void debounceInit();
+
+//輸入一次原始掃描結果，回傳防彈跳後的狀態
+const matrix_t& debounceUpdate(const matrix_t& raw, unsigned long nowMs);
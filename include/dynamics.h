@@ -0,0 +1,58 @@
+//打字動態：每次按下的按住時間（dwell）、相鄰兩次按下的間隔（flight）與最近一分鐘的 WPM
+//按下 / 放開時只更新固定大小的表（各加一格），不做其他計算也不送任何資料；
+//主機需要時透過 Feature 報告（USB_HID_REPORTID_DYNAMICS）分段讀出整張表，WPM 在讀取時才計算。
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+
+#define DYN_BUCKETS 16
+#define DYN_DWELL_SHIFT 4        //按住時間每格 16ms（最後一格含 240ms 以上）
+#define DYN_FLIGHT_SHIFT 5       //間隔每格 32ms（最後一格含 480ms 以上）
+#define DYN_FLIGHT_MAX_MS 1000   //間隔超過此值視為停頓，不計入
+#define DYN_HELD 8               //同時追蹤的按住中按鍵數（超過時不計按住時間）
+#define DYN_WPM_SLOTS 12
+#define DYN_WPM_SLOT_MS 5000UL   //12 格 x 5 秒 = 最近一分鐘
+
+//直方圖以共用指數的定點數表示：次數約為 buckets[i] << scale。
+//任一格滿 255 時整個直方圖減半、scale 加 1，保留分布形狀，大小固定。
+struct __attribute__((packed)) DynHistogram {
+  uint8_t scale;
+  uint8_t buckets[DYN_BUCKETS];
+};
+
+//主機讀取的整張表
+struct __attribute__((packed)) DynamicsTable {
+  uint8_t dwellShift;   //DYN_DWELL_SHIFT
+  uint8_t flightShift;  //DYN_FLIGHT_SHIFT
+  DynHistogram dwell[LAYER_COUNT];   //依按下時查到的層
+  DynHistogram flight[LAYER_COUNT];  //依後一個鍵查到的層
+  uint8_t keyDwell[KEY_COUNT];       //每個鍵的平均按住時間（ms，移動平均 1/8，上限 255，0 為尚無資料）
+};
+
+//主機讀取：Feature 報告每次回傳整張表的一段（與熱度表相同的分段方式）
+#define DYN_REPORT_VERSION 1
+#define DYN_CHUNK_SIZE 55
+struct __attribute__((packed)) DynamicsChunk {
+  uint8_t version;
+  uint8_t length;    //本段有效長度
+  uint16_t offset;   //本段在表中的位移
+  uint16_t total;    //表的總長度
+  uint16_t wpmX10;   //最近一分鐘的 WPM x 10（每 5 次按下算一個字）
+  uint8_t data[DYN_CHUNK_SIZE];
+};
+
+//主機送來的命令：[報告 ID][命令][參數（u16）]
+enum DynamicsCommand : uint8_t {
+  DYN_CMD_SELECT = 1,  //之後讀取從參數指定的位移開始
+  DYN_CMD_CLEAR = 2,   //全部歸零
+};
+
+void dynamicsInit();
+
+//掃描流程中每個矩陣按鍵的按下 / 放開（layer 為這個鍵查到的層）
+void dynamicsRecord(uint8_t keyID, bool pressed, uint8_t layer, uint32_t nowMs);
+
+//供 HID Feature 報告使用（在 USB 中斷中呼叫）
+void dynamicsFillChunk(DynamicsChunk& chunk);
+void dynamicsCommand(uint8_t cmd, uint16_t arg);
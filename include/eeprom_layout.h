@@ -0,0 +1,15 @@
+//EEPROM 配置（ATmega32U4 共 1024 bytes）
+//各模組的存放位置集中在這裡，避免互相覆蓋。
+#pragma once
+
+#define EEPROM_SIZE 1024
+
+//按鍵熱度表：兩個輪流寫入的槽（見 heatmap.h）
+#define EEPROM_HEAT_SLOT_SIZE 280
+#define EEPROM_HEAT_SLOT_A 0
+#define EEPROM_HEAT_SLOT_B (EEPROM_HEAT_SLOT_A + EEPROM_HEAT_SLOT_SIZE)
+#define EEPROM_HEAT_END (EEPROM_HEAT_SLOT_B + EEPROM_HEAT_SLOT_SIZE)
+
+//鍵位表（見 keymap_store.h）：標頭 + 4 層 x 56 鍵的動作碼
+#define EEPROM_KEYMAP_ADDR EEPROM_HEAT_END
+#define EEPROM_KEYMAP_SIZE (EEPROM_SIZE - EEPROM_KEYMAP_ADDR)
@@ -0,0 +1,17 @@
+//EEPROM 背景寫入
+//一次寫入一個 byte 要 3.4ms，整段同步寫入會卡住掃描好幾百毫秒；
+//這裡每次呼叫 eepromWriterUpdate() 只在 EEPROM 空閒時寫一個有變化的 byte。
+//每份工作分成資料與標頭兩段，標頭最後寫，呼叫端以標頭中的 CRC 判斷內容是否完整。
+#pragma once
+
+#include <Arduino.h>
+
+//開始一份寫入工作；已有工作在進行時回傳 false。
+//寫入期間呼叫端不可改動 data / header 的內容。
+bool eepromWriterStart(uint16_t dataAddr, const void* data, uint16_t dataLen,
+                       uint16_t headerAddr, const void* header, uint8_t headerLen);
+
+bool eepromWriterBusy();
+
+//主迴圈每次呼叫
+void eepromWriterUpdate();
@@ -0,0 +1,14 @@
+//旋鈕（中斷解碼）
+//DT_PIN 0 = PD2（INT2）、CLK_PIN 1 = PD3（INT3），兩腳任一邊緣都觸發中斷解碼，
+//主迴圈只讀取累積的段數，迴圈再慢也不會漏掉。
+#pragma once
+
+#include <Arduino.h>
+
+void encoderInit();
+
+//取出上次呼叫後累積的段數（與原 RotaryEncoder 位置方向相同）
+int8_t encoderTakeDelta();
+
+//是否有尚未取出的段數（不取出，閒置喚醒時檢查用）
+bool encoderMoved();
@@ -0,0 +1,50 @@
+//按鍵事件串流：每個按下 / 放開都記進固定大小的環形緩衝區並編上序號，
+//以批次方式放進自訂 HID 介面的輸入報告（USB_HID_REPORTID_EVENTS）送給主機。
+//主機依序號發現漏收時，用同 ID 的 Feature 報告要求從指定序號重送。
+#pragma once
+
+#include <Arduino.h>
+
+#define EVENTS_VERSION 1
+
+//環形緩衝區大小（2 的次方）：可重送最近這麼多筆
+#define EVENTS_RING 32
+
+//一份報告最多帶幾筆、兩份報告的最短間隔
+#define EVENTS_PER_REPORT 14
+#define EVENTS_MIN_INTERVAL_MS 10
+
+//KeyEvent.info
+#define EVENT_INFO_PRESSED 0x80
+#define EVENT_INFO_LAYER_MASK 0x0F
+
+struct KeyEvent {
+  uint16_t timeMs;  //millis() 低 16 位，主機依前後順序還原
+  uint8_t keyID;
+  uint8_t info;     //EVENT_INFO_PRESSED | 按下時的層級
+};
+
+//EventReport.flags
+#define EVENTS_FLAG_RESYNC 0x01  //要求的序號已被覆蓋，從緩衝區中最舊的一筆開始
+
+//輸入報告內容（報告 ID 之後 63 bytes，little-endian）
+struct __attribute__((packed)) EventReport {
+  uint8_t version;
+  uint8_t count;      //本份報告的事件數
+  uint8_t flags;
+  uint16_t firstSeq;  //events[0] 的序號，之後依序加 1
+  uint16_t headSeq;   //下一筆事件會用的序號
+  KeyEvent events[EVENTS_PER_REPORT];
+};
+
+void eventsInit();
+void eventsRecord(uint8_t keyID, bool pressed, uint8_t layer, unsigned long nowMs);
+
+//有未送出的事件且距上次送出已超過最短間隔時送出一批
+void eventsUpdate(unsigned long nowMs);
+
+//主機要求從 seq 開始重送（在 USB 中斷中呼叫）
+void eventsRequestRetransmit(uint16_t seq);
+
+//下一份報告的起始序號（有未處理的重送要求時為要求的序號；在 USB 中斷中呼叫）
+uint16_t eventsSendStart();
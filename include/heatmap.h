@@ -0,0 +1,56 @@
+//按鍵熱度表：每層每鍵的按下次數，保存在 EEPROM，斷電後仍保留
+//RAM 中每個計數器平時只佔 1 byte；超過 255 的計數器另外配置 2 bytes 的高位
+//（最多 HEAT_OVERFLOW_COUNT 個），高位用完或達上限時停在最大值不再增加。
+//寫入 EEPROM 時集中批次進行，兩個槽輪流寫入並以 CRC 檢查，寫到一半斷電也不會毀損。
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+
+#define HEAT_COUNTERS (LAYER_COUNT * KEY_COUNT)  //計數器編號 = layer * KEY_COUNT + keyID
+#define HEAT_OVERFLOW_COUNT 16
+#define HEAT_OVERFLOW_FREE 0xFF
+
+//停止打字超過 HEAT_FLUSH_IDLE_MS 且距上次寫入超過 HEAT_FLUSH_INTERVAL_MS 才寫入 EEPROM
+//（開機後第一次寫入只看 HEAT_FLUSH_IDLE_MS）
+#define HEAT_FLUSH_IDLE_MS 30000UL
+#define HEAT_FLUSH_INTERVAL_MS 600000UL
+
+struct __attribute__((packed)) HeatOverflow {
+  uint8_t index;  //計數器編號，HEAT_OVERFLOW_FREE 為未使用
+  uint16_t high;  //次數的高位（次數 = high * 256 + low）
+};
+
+//熱度表（RAM 與 EEPROM 相同格式，主機也直接讀這個格式）
+struct __attribute__((packed)) HeatTable {
+  uint8_t low[HEAT_COUNTERS];
+  HeatOverflow overflow[HEAT_OVERFLOW_COUNT];
+};
+
+//主機讀取：Feature 報告（USB_HID_REPORTID_HEATMAP）每次回傳熱度表的一段
+#define HEAT_REPORT_VERSION 1
+#define HEAT_CHUNK_SIZE 57
+struct __attribute__((packed)) HeatChunk {
+  uint8_t version;
+  uint8_t length;    //本段有效長度
+  uint16_t offset;   //本段在熱度表中的位移
+  uint16_t total;    //熱度表總長度
+  uint8_t data[HEAT_CHUNK_SIZE];
+};
+
+//主機送來的命令：[報告 ID][命令][參數（u16）]
+enum HeatCommand : uint8_t {
+  HEAT_CMD_SELECT = 1,  //之後讀取從參數指定的位移開始
+  HEAT_CMD_FLUSH = 2,   //立即寫入 EEPROM
+  HEAT_CMD_CLEAR = 3,   //全部歸零並寫入
+};
+
+void heatInit();
+void heatCount(uint8_t keyID, uint8_t layer);
+
+//依條件啟動寫入；寫入中每次只在 EEPROM 空閒時寫一個 byte，不會卡住主迴圈
+void heatUpdate(unsigned long nowMs);
+
+//供 HID Feature 報告使用（在 USB 中斷中呼叫）
+void heatFillChunk(HeatChunk& chunk);
+void heatCommand(uint8_t cmd, uint16_t arg);
@@ -0,0 +1,24 @@
+//按鍵處理流程（與硬體無關的部分）
+//韌體由 scheduler 的固定頻率節拍呼叫 keyboardScan()，原生模擬（src/native/）則直接呼叫。
+#pragma once
+
+#include <Arduino.h>
+
+//防彈跳、鍵位表、層與組合鍵的初始化（硬體介面與回報由呼叫端先初始化）
+void keyboardInit();
+
+//掃描一次並派送所有變化，最後送出（或累積）本次的回報
+void keyboardScan();
+
+//沒有按住的鍵與播放中的巨集（可以進入閒置，見 power.h）
+bool keyboardQuiet();
+
+//判定完成的按鍵事件（派送、組合鍵觸發時呼叫）：記進事件串流、熱度表與打字動態。
+//layer 為實際查表的層，timeMs 為實體按下 / 放開的時間（點按 / 按住、組合鍵判定前的時間）
+void keyboardRecord(byte keyID, bool pressed, byte layer, uint32_t timeMs);
+
+//最近一次有按鍵變化或旋鈕轉動的 millis()
+uint32_t keyboardLastActivity();
+
+//閒置結束、恢復掃描之前呼叫：掃描週期從這裡重新量起
+void keyboardWake();
@@ -0,0 +1,76 @@
+//可在執行時修改的鍵位表
+//開機時從 EEPROM 載入（CRC 不符或沒有資料時使用編譯時的 actionmaps），
+//之後查表都讀 RAM 中的 keymap。主機透過自訂 HID 介面的 Feature 報告
+//（USB_HID_REPORTID_KEYMAP）讀寫任意鍵位，確認 CRC 後才存回 EEPROM。
+//以 OHK_KEYMAP_EDIT=0 編譯時不佔 RAM：查表與讀取都直接用 PROGMEM 中的預設表，修改命令一律回報 KEYMAP_READ_ONLY。
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+#include "actions.h"
+
+#define KEYMAP_REPORT_VERSION 1
+#define KEYMAP_CHUNK 27  //每份報告最多帶幾個動作碼（一層 56 鍵分 3 次）
+
+//主機送來的命令（Feature 報告，報告 ID 之後）
+enum KeymapCommand : uint8_t {
+  KEYMAP_CMD_READ = 1,    //選擇之後讀取的範圍（layer、start、count）
+  KEYMAP_CMD_WRITE = 2,   //寫入 RAM 並立即生效（layer、start、count、actions）
+  KEYMAP_CMD_COMMIT = 3,  //整張表的 CRC 與 crc 相符才存回 EEPROM，不符則還原為已儲存的內容
+  KEYMAP_CMD_DEFAULT = 4, //還原為編譯時的鍵位表並清除 EEPROM 中的資料
+  KEYMAP_CMD_REVERT = 5,  //放棄未儲存的修改
+};
+
+struct __attribute__((packed)) KeymapRequest {
+  uint8_t cmd;
+  uint8_t layer;
+  uint8_t start;
+  uint8_t count;
+  uint16_t crc;
+  action_t actions[KEYMAP_CHUNK];
+  uint8_t reserved[3];
+};
+
+//最近一個命令的結果
+enum KeymapStatus : uint8_t {
+  KEYMAP_OK = 0,
+  KEYMAP_BUSY = 1,          //還在寫入 EEPROM 或處理上一個命令（此時不帶鍵位內容）
+  KEYMAP_BAD_ARGS = 2,
+  KEYMAP_CRC_MISMATCH = 3,  //已還原為儲存的內容
+  KEYMAP_READ_ONLY = 4,     //韌體以 OHK_KEYMAP_EDIT=0 編譯，鍵位表不可修改
+};
+
+//目前鍵位表的來源
+enum KeymapSource : uint8_t {
+  KEYMAP_SOURCE_DEFAULT = 0,
+  KEYMAP_SOURCE_EEPROM = 1,
+  KEYMAP_SOURCE_MODIFIED = 2,  //有尚未儲存的修改
+};
+
+//主機讀取（Feature 報告，報告 ID 之後）
+struct __attribute__((packed)) KeymapReport {
+  uint8_t version;
+  uint8_t status;
+  uint8_t source;
+  uint8_t layer;
+  uint8_t start;
+  uint8_t count;
+  uint16_t crc;  //RAM 中整張表的 CRC16
+  action_t actions[KEYMAP_CHUNK];
+  uint8_t reserved[1];
+};
+
+#if OHK_KEYMAP_EDIT
+//RAM 中的鍵位表（actionAt() 查這裡）
+extern action_t keymap[LAYER_COUNT][KEY_COUNT];
+#endif
+
+void keymapInit();
+
+//處理主機送來的命令、背景存回 EEPROM
+void keymapUpdate();
+
+//供 HID Feature 報告使用（在 USB 中斷中呼叫）
+//keymapRequest() 在上一個命令還沒處理完時回傳 false，讓主機重送
+bool keymapRequest(const KeymapRequest& request);
+void keymapFillReport(KeymapReport& report);
@@ -0,0 +1,34 @@
+//層堆疊
+//每一層對應遮罩中的一個 bit，作用中的層 = 開啟的層 | 預設層。
+//查鍵時取「作用中且該鍵不是透明」的最高層，每個鍵預先算好非透明層的遮罩，
+//因此不論幾層，查一次都只需固定幾個位元運算。
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+
+typedef uint16_t layer_mask_t;  //最多 16 層
+
+static_assert(LAYER_COUNT <= 16, "layer_mask_t holds at most 16 layers");
+
+void layersInit();
+
+//鍵位表改變後重算每個鍵的非透明層遮罩
+void layersRebuild();
+
+//按鍵目前應該查哪一層
+byte layersResolve(byte keyID);
+
+void layerOn(byte layer);
+void layerOff(byte layer);
+void layerToggle(byte layer);
+void layerSetDefault(byte layer);
+
+//關閉按住（MO / LT / OSL）開啟的層，只留下 TG 開啟的層與預設層
+void layerClear();
+
+//單次層：開啟後只對下一個按鍵有效
+void layerOneShot(byte layer);
+void layerOneShotRelease(byte layer);
+//一般按鍵按下並派送後呼叫，關閉用掉的單次層
+void layerOneShotConsume();
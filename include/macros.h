@@ -0,0 +1,44 @@
+//巨集輸出：PROGMEM 中的位元組碼，由 macroUpdate() 逐步送出
+//每一步最多產生一份回報變化，上一份送出（下一個 USB frame）後才執行下一步，
+//以主機接受的最快速度打字，同時矩陣掃描與其他按鍵照常運作。
+//
+//每個指令為 1 byte 操作碼 + 1 byte 參數，以 MACRO_END 結束：
+//  MACRO_DOWN / MACRO_UP 鍵碼：按下 / 放開（修飾鍵與實體按鍵共用計數）
+//  MACRO_TAP 鍵碼         ：按下並在下一份回報放開
+//  MACRO_WAIT 毫秒        ：等待（最多 255，需要更久就連續寫幾個）
+//  MACRO_LAYER_ON / OFF 層：開啟 / 關閉層（不產生回報，直接執行下一個指令）
+#pragma once
+
+#include <Arduino.h>
+
+enum MacroOp : uint8_t {
+  MACRO_END = 0,
+  MACRO_DOWN = 1,
+  MACRO_UP = 2,
+  MACRO_TAP = 3,
+  MACRO_WAIT = 4,
+  MACRO_LAYER_ON = 5,
+  MACRO_LAYER_OFF = 6,
+};
+
+//巨集內容的簡寫
+#define M_DOWN(code)      MACRO_DOWN, (code)
+#define M_UP(code)        MACRO_UP, (code)
+#define M_TAP(code)       MACRO_TAP, (code)
+#define M_WAIT(ms)        MACRO_WAIT, (ms)
+#define M_LAYER_ON(layer) MACRO_LAYER_ON, (layer)
+#define M_LAYER_OFF(layer) MACRO_LAYER_OFF, (layer)
+#define M_END             MACRO_END
+
+//巨集表（定義於 keymap.cpp）：每格指向一段 PROGMEM 位元組碼
+extern const uint8_t* const macros[] PROGMEM;
+extern const uint8_t macroCount;
+
+//排入巨集（正在播放時依序排隊）
+void macroPlay(uint8_t index);
+
+//每次迴圈在 reportFlush() 之前呼叫
+void macroUpdate(uint32_t nowMs);
+
+//是否正在播放或有排隊中的巨集
+bool macroBusy();
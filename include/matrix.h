@@ -0,0 +1,35 @@
+//矩陣掃描（直接操作 AVR 埠暫存器）
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+
+//整個矩陣的狀態：第 keyID 位為 1 表示按下
+//rows[r] 的第 c 位即 keyID = r * 8 + c（AVR 為 little-endian）
+//旋鈕按鍵放在第 ENC_SW_KEY_ID（56）位
+union matrix_t {
+  uint64_t word;
+  uint8_t rows[8];
+};
+
+void matrixInit();
+
+//完整掃描一次（含旋鈕按鍵），回傳目前的原始狀態（未防彈跳）
+const matrix_t& matrixScan();
+
+//閒置（見 power.h）：所有列輸出低電位，任何鍵按下都會把所在的行拉低。
+//同時開啟行腳位與旋鈕按鍵的喚醒中斷（PB 各腳用 pin change、PE6 用 INT6 低電位）；
+//PD7 那一行沒有中斷可用，由 matrixIdlePressed() 在每次醒來時檢查。
+void matrixIdleArm();
+void matrixIdleDisarm();
+
+//重新開啟 INT6（觸發過一次就會關掉；確定沒有按下後、睡眠前呼叫）
+void matrixIdleRearm();
+
+//閒置中是否有任何鍵（含旋鈕按鍵）按下
+bool matrixIdlePressed();
+
+//鬼鍵過濾：任兩行在兩個以上的列同時按下（矩形的角），第四個角可能是鬼鍵，
+//這兩行在共同列上新出現的按下先不回報，直到矩形解除；已按下的鍵不受影響。
+//prev 為上次回報出去的狀態。OHK_GHOST_FILTER 為 0 時直接回傳 state。
+const matrix_t& matrixGhostFilter(const matrix_t& state, const matrix_t& prev);
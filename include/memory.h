@@ -0,0 +1,25 @@
+//RAM 使用量監測
+//開機時（.init1，C 執行環境設定之前）把 heap 頂端到 RAMEND 全部填上 MEMORY_CANARY，
+//之後 memoryUpdate() 每次從 heap 頂端往上檢查一小段，找出堆疊曾經寫到的最低位址（high-water mark）。
+//堆疊剛好寫入與 MEMORY_CANARY 相同的值時會少算幾個 byte，作為監測已經足夠。
+#pragma once
+
+#include <Arduino.h>
+
+#define MEMORY_CANARY 0xC5
+#define MEMORY_SCAN_CHUNK 64  //每次 memoryUpdate() 最多檢查幾個 byte（約 0.03ms）
+
+//單位皆為 byte
+struct __attribute__((packed)) MemoryStats {
+  uint16_t staticBytes;  //.data + .bss（編譯時決定，建置時另以 tools/ram_budget.py 檢查）
+  uint16_t heapBytes;    //malloc 用到的大小（沒有使用 malloc 時為 0）
+  uint16_t stackPeak;    //開機以來堆疊最深用到的大小（含中斷）
+  uint16_t freeMin;      //開機以來 heap 與堆疊之間最少剩下的大小
+};
+
+void memoryInit();
+
+//背景工作：檢查下一段；堆疊比之前更深時標記 telemetryDirty
+void memoryUpdate();
+
+void memoryGetStats(MemoryStats& stats);
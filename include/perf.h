@@ -0,0 +1,61 @@
+//效能量測：Timer1（不分頻）延伸成 32-bit cycle 計數，
+//把掃描時間、動作派送、事件到回報的延遲、迴圈週期與狀態回報耗時記成固定大小的直方圖。
+//主機透過自訂 HID 介面的 Feature 報告（USB_HID_REPORTID_PERF）讀取與重置。
+#pragma once
+
+#include <Arduino.h>
+
+enum PerfHistogram : uint8_t {
+  PERF_SCAN = 0,       //矩陣掃描 + 防彈跳
+  PERF_LATENCY = 1,    //偵測到按鍵變化到回報送出
+  PERF_LOOP = 2,       //掃描週期（兩次節拍掃描的間隔）
+  PERF_TELEMETRY = 3,  //狀態回報送出耗時
+  PERF_JITTER = 4,     //掃描節拍到掃描開始的延遲（見 scheduler.h）
+  PERF_WAKE = 5,       //閒置中醒來到第一次掃描開始（見 power.h）
+  PERF_DISPATCH = 6,   //單一按鍵事件的動作派送（查表到寫進回報）
+  PERF_MATRIX = 7,     //只讀取矩陣（不含防彈跳），換算可達的掃描頻率
+  PERF_HISTOGRAM_COUNT
+};
+
+//直方圖以 2 的次方分格：第 0 格 < 2^(SHIFT+1) cycle，第 i 格為 [2^(i+SHIFT), 2^(i+SHIFT+1))，
+//最後一格含以上全部（16 格涵蓋 2us ~ 32ms）
+#define PERF_BUCKETS 16
+#define PERF_BUCKET_SHIFT 4
+
+//Feature 報告內容（報告 ID 之後）
+#define PERF_REPORT_VERSION 1
+struct PerfReport {
+  uint8_t version;
+  uint8_t histogram;
+  uint8_t bucketShift;
+  uint8_t bucketCount;
+  uint32_t count;
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint16_t buckets[PERF_BUCKETS];
+};
+
+//主機送來的命令（Feature 報告第一個位元組）
+enum PerfCommand : uint8_t {
+  PERF_CMD_SELECT = 1,  //選擇之後讀取的直方圖（參數：編號）
+  PERF_CMD_RESET = 2,   //清除直方圖（參數：編號，0xFF 為全部）
+};
+
+void perfInit();
+
+//目前的 32-bit cycle 計數（16MHz，約 268 秒循環一次）
+uint32_t perfNow();
+
+//啟動 perfNow() 的計時器（perf_timer.cpp；原生模擬另外提供）
+void perfTimerInit();
+
+void perfRecord(uint8_t histogram, uint32_t cycles);
+
+//延遲量測：掃描到第一個變化時標記起點，回報送出時記錄
+void perfMarkEvent(uint32_t start);
+void perfMarkReport();
+void perfCancelEvent();
+
+//供 HID Feature 報告使用（在 USB 中斷中呼叫）
+void perfFillReport(PerfReport& report);
+void perfCommand(uint8_t cmd, uint8_t arg);
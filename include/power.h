@@ -0,0 +1,36 @@
+//低功耗閒置
+//沒有按住的鍵且超過 IDLE_TIMEOUT_MS 沒有輸入（或 USB 被主機暫停）時進入閒置：
+//停掉掃描節拍、所有列拉低並開啟行腳位 / 旋鈕的喚醒中斷，背景工作之間讓 MCU 睡眠。
+//  USB 正常：SLEEP_MODE_IDLE，USB 與計時器照常運作（SOF、millis 每毫秒叫醒一次）
+//  USB 暫停：凍結 USB 時脈、關 PLL 後進入 power-down，看門狗每 16ms 叫醒檢查 PD7 那一行；
+//           有按鍵時送出遠端喚醒（主機允許時），回報等主機恢復後送出
+//醒來時若有任何按鍵或旋鈕輸入就離開閒置並立即掃描一次，第一個按下在醒來的同一個掃描週期內派送。
+//醒來到掃描開始的時間記在 PERF_JITTER 之後的 PERF_WAKE 直方圖。
+#pragma once
+
+#include <Arduino.h>
+
+//單位皆為毫秒 / 次數（開機以來累計）
+struct __attribute__((packed)) PowerStats {
+  uint32_t idleMs;       //處於閒置狀態的時間
+  uint32_t sleepMs;      //其中 MCU 實際睡眠的時間（power-down 以看門狗週期估計）
+  uint16_t idleCount;    //進入閒置的次數
+  uint16_t hostWakeups;  //USB 暫停中因按鍵送出遠端喚醒的次數
+};
+
+void powerInit();
+
+//是否該進入閒置（主迴圈在沒有節拍時呼叫）
+bool powerIdleDue();
+
+//進入 / 離開閒置；離開後呼叫端應立即掃描一次
+void powerEnter();
+void powerExit();
+
+//閒置中是否有按鍵或旋鈕輸入（或主機恢復後有待送的回報）
+bool powerInputPending();
+
+//睡到下一個中斷（或下一個輸入）
+void powerSleep();
+
+void powerGetStats(PowerStats& stats);
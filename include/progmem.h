@@ -0,0 +1,56 @@
+//PROGMEM 表的型別化讀取
+//pgmRead(&table[i]) 依型別大小展開成 pgm_read_byte / word / dword（各一組 LPM，與直接呼叫相同），
+//其他大小（結構、64-bit 遮罩）用 memcpy_P。查表的地方不必再自己挑選讀取函式或轉型。
+#pragma once
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+template <uint8_t Size>
+struct PgmReader {
+  template <typename T>
+  static inline T read(const T* p) {
+    T value;
+    memcpy_P(&value, p, sizeof(T));
+    return value;
+  }
+};
+
+template <>
+struct PgmReader<1> {
+  template <typename T>
+  static inline T read(const T* p) {
+    const uint8_t raw = pgm_read_byte(p);
+    T value;
+    memcpy(&value, &raw, sizeof(T));
+    return value;
+  }
+};
+
+template <>
+struct PgmReader<2> {
+  template <typename T>
+  static inline T read(const T* p) {
+    const uint16_t raw = pgm_read_word(p);
+    T value;
+    memcpy(&value, &raw, sizeof(T));
+    return value;
+  }
+};
+
+template <>
+struct PgmReader<4> {
+  template <typename T>
+  static inline T read(const T* p) {
+    const uint32_t raw = pgm_read_dword(p);
+    T value;
+    memcpy(&value, &raw, sizeof(T));
+    return value;
+  }
+};
+
+//讀取 PROGMEM 中的一個值（p 必須指向 PROGMEM）
+template <typename T>
+static inline T pgmRead(const T* p) {
+  return PgmReader<sizeof(T)>::template read<T>(p);
+}
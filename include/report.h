@@ -0,0 +1,28 @@
+//HID 回報組裝
+//一次掃描中所有的按下 / 放開先累積在回報裡，掃描結束後由 reportFlush() 一次送出，
+//同一個 USB frame（1ms）最多送出一份鍵盤與一份滑鼠回報，主機不會看到組合鍵只套用一半的中間狀態。
+#pragma once
+
+#include <Arduino.h>
+
+void reportBegin();
+
+//鍵盤模式：NKRO（位元圖回報，56 鍵全部可同時按下）或 6KRO 開機鍵盤
+//主機要求開機協定（BIOS 等）時一律使用 6KRO 開機鍵盤
+void reportSetNkro(bool on);
+bool reportNkro();
+
+void reportKeyPress(uint8_t code);
+void reportKeyRelease(uint8_t code);
+void reportReleaseAll();
+
+void reportMousePress(uint8_t buttons);
+void reportMouseRelease(uint8_t buttons);
+//滾輪單位：主機開啟高解析度時為 1/USB_HID_WHEEL_MULTIPLIER 格，否則為 1 格
+void reportMouseWheel(int16_t delta);
+
+//是否還有尚未送出的變化（包括延到下一份回報的放開）
+bool reportPending();
+
+//每次掃描結束時呼叫；與上次送出在同一個 USB frame 時延到下一次
+void reportFlush();
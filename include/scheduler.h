@@ -0,0 +1,15 @@
+//固定頻率掃描排程：Timer3 以 SCAN_RATE_HZ 產生節拍（CTC 模式、不分頻），
+//每個節拍執行一次掃描 / 派送 / 回報，節拍之間的空檔輪流執行低優先工作。
+//節拍到掃描開始的延遲（抖動）記在 PERF_JITTER 直方圖。
+#pragma once
+
+#include <Arduino.h>
+
+void schedulerInit();
+
+//是否有新的節拍；有則記錄這次的抖動（錯過的節拍算進延遲）並回傳 true
+bool schedulerTick();
+
+//閒置時停掉節拍（見 power.h）；恢復時從頭計時，閒置期間不算錯過的節拍
+void schedulerPause();
+void schedulerResume();
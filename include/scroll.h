@@ -0,0 +1,9 @@
+//旋鈕滾動：依轉速加速，主機支援時輸出高解析度滾輪單位
+#pragma once
+
+#include <Arduino.h>
+
+void scrollInit();
+
+//加入旋鈕段數（順時針為正），換算後寫進本 frame 的滑鼠回報
+void scrollDetents(int8_t detents, unsigned long nowMs);
@@ -0,0 +1,15 @@
+//HID 監控用統計資料（定義於 keyboard.cpp）
+#pragma once
+
+#include <Arduino.h>
+
+//目前層級
+extern byte currentLayer;
+
+extern uint32_t keyPressCount;
+extern uint32_t fnPressCount;
+extern uint32_t encoderTurnCount;
+extern uint32_t mouseClickCount;
+extern uint8_t lastKeyId;
+extern uint8_t lastKeyLayer;
+extern bool telemetryDirty;
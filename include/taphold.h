@@ -0,0 +1,13 @@
+//點按 / 按住判定（MT、LT 鍵）
+//只有按下點按 / 按住鍵、還沒判定的這段時間才把後續事件暫存起來，
+//判定後依原順序重新派送；沒有待判定的鍵時事件直接派送，不增加延遲。
+//判定方式見 config.h 的 OHK_TAP_HOLD 與 TAPPING_TERM_MS。
+#pragma once
+
+#include <Arduino.h>
+
+//按鍵事件（由組合鍵判定放行後送進來，見 combos.h；nowMs 為實體按下 / 放開的時間）
+void tapHoldEvent(byte keyID, bool pressed, uint32_t nowMs);
+
+//每次迴圈呼叫：待判定的鍵按住超過 TAPPING_TERM_MS 即判定為按住
+void tapHoldUpdate(uint32_t nowMs);
@@ -0,0 +1,50 @@
+//HID 監控用狀態回報
+//放在自訂 HID 介面的廠商集合中（輸入報告 USB_HID_REPORTID_TELEMETRY，固定 64 bytes），
+//計數器完整 32-bit；只在內容與上次送出的不同時才送，閒置時不佔 USB 頻寬。
+#pragma once
+
+#include <Arduino.h>
+#include "memory.h"
+#include "power.h"
+
+#define TELEMETRY_VERSION 3
+
+//兩次回報的最短間隔（與滑鼠共用端點，不必每個 frame 都送）
+#define TELEMETRY_MIN_INTERVAL_MS 20
+
+//changed 欄位：與上一份回報相比有變化的欄位
+#define TELEMETRY_CHANGED_LAYER 0x01
+#define TELEMETRY_CHANGED_LAST_KEY 0x02
+#define TELEMETRY_CHANGED_KEY_PRESS 0x04
+#define TELEMETRY_CHANGED_FN_PRESS 0x08
+#define TELEMETRY_CHANGED_ENCODER 0x10
+#define TELEMETRY_CHANGED_MOUSE_CLICK 0x20
+#define TELEMETRY_CHANGED_MEMORY 0x40
+#define TELEMETRY_CHANGED_POWER 0x80
+#define TELEMETRY_CHANGED_ALL 0xFF
+
+//輸入報告內容（報告 ID 之後 63 bytes，little-endian）
+struct __attribute__((packed)) TelemetryReport {
+  uint8_t version;
+  uint8_t seq;           //每送出一份加 1，主機可據此發現漏收
+  uint8_t changed;       //TELEMETRY_CHANGED_*
+  uint8_t currentLayer;
+  uint8_t lastKeyId;
+  uint8_t lastKeyLayer;
+  uint32_t keyPressCount;
+  uint32_t fnPressCount;
+  uint32_t encoderTurnCount;
+  uint32_t mouseClickCount;
+  uint32_t uptimeMs;     //送出時的 millis()
+  MemoryStats memory;    //RAM 使用量（見 memory.h）
+  PowerStats power;      //閒置與睡眠時間（見 power.h）
+  uint8_t reserved[17];
+};
+
+void telemetryInit();
+
+//統計有變化（telemetryDirty）且距上次送出已超過最短間隔時送出一份回報
+void telemetryUpdate(unsigned long nowMs);
+
+//供 HID Feature 報告使用（在 USB 中斷中呼叫）：最近一次送出的完整內容
+void telemetryFillReport(TelemetryReport& report);
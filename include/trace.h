@@ -0,0 +1,39 @@
+//除錯追蹤：固定大小的二進位環形緩衝區
+//主迴圈與中斷都能寫入，不配置記憶體、不阻塞；主機打開序列埠（DTR）時才送出。
+//只有以 -DOHK_TRACE 編譯（debug 環境）時才存在，正式版完全不佔空間。
+#pragma once
+
+#include <Arduino.h>
+
+//事件種類
+enum TraceEvent : uint8_t {
+  TRACE_KEY_DOWN = 1,  //按下：keyID、layer、action
+  TRACE_KEY_UP = 2,    //放開：keyID、layer、action
+  TRACE_LAYER = 3,     //層級切換：layer 為新層級
+  TRACE_DROPPED = 4,   //緩衝區滿而遺失的筆數（放在 action）
+};
+
+#ifdef OHK_TRACE
+
+//每筆 8 bytes，以同步位元組 TRACE_SYNC 開頭方便主機對齊
+#define TRACE_SYNC 0xA5
+struct TraceRecord {
+  uint8_t sync;
+  uint8_t event;
+  uint8_t keyID;
+  uint8_t layer;
+  uint16_t action;
+  uint16_t timeMs;  //millis() 低 16 位
+};
+
+void traceWrite(uint8_t event, uint8_t keyID, uint8_t layer, uint16_t action);
+void traceDrain();
+
+#define TRACE(event, keyID, layer, action) traceWrite((event), (keyID), (layer), (action))
+
+#else
+
+#define TRACE(event, keyID, layer, action) do {} while (0)
+static inline void traceDrain() {}
+
+#endif
@@ -0,0 +1,58 @@
+//自訂 HID 介面（PluggableUSB）
+//核心的 HID() 與 HID-Project 的滑鼠不處理 Feature 報告，無法得知主機是否開啟
+//高解析度滾輪（Resolution Multiplier），因此滑鼠改由這個介面提供。
+//ATmega32U4 扣掉 CDC 後只剩 3 個端點（HID()、BootKeyboard、本介面），
+//之後的自訂報告也都放在這個介面上，以報告 ID 區分。
+#pragma once
+
+#include <Arduino.h>
+#include <HID.h>
+
+//報告 ID
+#define USB_HID_REPORTID_MOUSE 1
+#define USB_HID_REPORTID_PERF 2   //效能直方圖（Feature，見 perf.h）
+#define USB_HID_REPORTID_TELEMETRY 3   //狀態回報（Input / Feature，見 telemetry.h）
+#define USB_HID_REPORTID_EVENTS 4   //按鍵事件串流（Input，Feature 要求重送，見 events.h）
+#define USB_HID_REPORTID_HEATMAP 5   //按鍵熱度表（Feature，見 heatmap.h）
+#define USB_HID_REPORTID_KEYMAP 6   //鍵位表讀寫（Feature，見 keymap_store.h）
+#define USB_HID_REPORTID_DYNAMICS 7   //打字動態統計（Feature，見 dynamics.h）
+
+//自訂報告所在的廠商定義集合
+#define USB_HID_VENDOR_USAGE_PAGE 0xFF4B
+#define USB_HID_VENDOR_USAGE 0x01
+
+//滑鼠輸入報告（報告 ID 之後的內容）
+struct UsbHidMouseReport {
+  uint8_t buttons;
+  int8_t xAxis;
+  int8_t yAxis;
+  int16_t wheel;
+};
+
+//高解析度滾輪：主機開啟後，每一格（notch）等於 USB_HID_WHEEL_MULTIPLIER 個單位
+#define USB_HID_WHEEL_MULTIPLIER 8
+
+class UsbHid_ : public PluggableUSBModule {
+public:
+  UsbHid_();
+
+  int sendReport(uint8_t id, const void* data, int len);
+
+  //主機設定的滾輪倍率（未開啟高解析度時為 1）
+  uint8_t wheelMultiplier() const {
+    return resolution ? USB_HID_WHEEL_MULTIPLIER : 1;
+  }
+
+protected:
+  int getInterface(uint8_t* interfaceCount);
+  int getDescriptor(USBSetup& setup);
+  bool setup(USBSetup& setup);
+
+private:
+  uint8_t epType[1];
+  uint8_t protocol;
+  uint8_t idle;
+  uint8_t resolution;
+};
+
+extern UsbHid_ UsbHid;
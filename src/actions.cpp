@@ -0,0 +1,193 @@
+//動作派送：查表一次，依動作類型把鍵盤 / 滑鼠變化寫進回報或切換層級
+
+#include <HID-Project.h>
+#include "actions.h"
+#include "layers.h"
+#include "stats.h"
+#include "report.h"
+#include "trace.h"
+#include "macros.h"
+#include "perf.h"
+#include "keyboard.h"
+
+//每個鍵按下時查到的層（每鍵 4 bits）：放開時查同一層的動作，
+//做的事與按下時完全對應，切換層級不必放開其他按住的鍵
+static uint8_t pressLayers[(KEY_COUNT + 1) / 2];
+
+static byte pressLayer(byte keyID) {
+  return (pressLayers[keyID >> 1] >> ((keyID & 1) * 4)) & 0x0F;
+}
+
+static void setPressLayer(byte keyID, byte layer) {
+  const uint8_t shift = (keyID & 1) * 4;
+  pressLayers[keyID >> 1] = (pressLayers[keyID >> 1] & ~(0x0F << shift)) | (layer << shift);
+}
+
+//點按 / 按住鍵這次按下的判定（每鍵 1 bit），放開時做對應的動作
+static uint8_t holdKeys[(KEY_COUNT + 7) / 8];
+
+void actionSetHold(byte keyID, bool hold) {
+  if (hold) holdKeys[keyID >> 3] |= (uint8_t)(1 << (keyID & 7));
+  else holdKeys[keyID >> 3] &= (uint8_t)~(1 << (keyID & 7));
+}
+
+static bool isHold(byte keyID) {
+  return (holdKeys[keyID >> 3] >> (keyID & 7)) & 1;
+}
+
+//同一個修飾鍵可能由幾個按住的鍵共用（組合鍵、單獨的 CTRL 鍵），最後一個放開時才放開
+static uint8_t modRefs[4];
+
+static void modAction(uint8_t i, bool pressed) {
+  if (pressed) {
+    if (modRefs[i]++ == 0) {
+      reportKeyPress(KEY_LEFT_CTRL + i);
+    }
+  }
+  else if (modRefs[i] && --modRefs[i] == 0) {
+    reportKeyRelease(KEY_LEFT_CTRL + i);
+  }
+}
+
+void actionReleaseAll() {
+  memset(modRefs, 0, sizeof(modRefs));
+  reportReleaseAll();
+}
+
+//按下或放開修飾鍵遮罩中的每個修飾鍵，再處理鍵碼本身
+static void keyAction(uint8_t mods, uint8_t code, bool pressed) {
+  for (uint8_t i = 0; i < 4; i++) {
+    if (mods & (1 << i)) {
+      modAction(i, pressed);
+    }
+  }
+  if (code >= KEY_LEFT_CTRL && code <= KEY_LEFT_GUI) {
+    modAction(code - KEY_LEFT_CTRL, pressed);
+  }
+  else if (pressed) reportKeyPress(code);
+  else reportKeyRelease(code);
+}
+
+void actionKey(uint8_t code, bool pressed) {
+  keyAction(0, code, pressed);
+}
+
+static void layerAction(uint8_t op, byte layer, bool pressed) {
+  if (layer >= LAYER_COUNT) {
+    return;
+  }
+  switch (op) {
+    case LAYER_OP_MOMENTARY:
+      if (pressed) layerOn(layer);
+      else layerOff(layer);
+      break;
+    case LAYER_OP_TOGGLE:
+      if (pressed) layerToggle(layer);
+      break;
+    case LAYER_OP_ONESHOT:
+      if (pressed) layerOneShot(layer);
+      else layerOneShotRelease(layer);
+      break;
+    case LAYER_OP_DEFAULT:
+      if (pressed) layerSetDefault(layer);
+      break;
+  }
+}
+
+//執行一個動作（hold 為點按 / 按住鍵這次的判定）
+static void runAction(action_t action, bool pressed, bool hold) {
+  const uint8_t type = ACTION_TYPE(action);
+  switch (type) {
+    case ACT_KEY:
+      keyAction(ACTION_PARAM(action), ACTION_CODE(action), pressed);
+      break;
+
+    case ACT_LAYER:
+      layerAction(ACTION_PARAM(action), ACTION_CODE(action), pressed);
+      break;
+
+    case ACT_MOD_TAP:
+      if (hold) keyAction(ACTION_PARAM(action), 0, pressed);
+      else keyAction(0, ACTION_CODE(action), pressed);
+      break;
+
+    case ACT_LAYER_TAP:
+      if (hold) layerAction(LAYER_OP_MOMENTARY, ACTION_PARAM(action), pressed);
+      else keyAction(0, ACTION_CODE(action), pressed);
+      break;
+
+    case ACT_MACRO:
+      if (pressed) macroPlay(ACTION_CODE(action));
+      break;
+
+    case ACT_MOUSE:
+      if (pressed) reportMousePress(ACTION_CODE(action));
+      else reportMouseRelease(ACTION_CODE(action));
+      break;
+
+    case ACT_SYSTEM:
+      if (pressed && ACTION_CODE(action) == SYS_NKRO_TOGGLE) {
+        //切換介面會放開舊介面上的所有鍵，修飾鍵計數一併歸零
+        actionReleaseAll();
+        reportSetNkro(!reportNkro());
+      }
+      break;
+  }
+
+  //單次層在下一個非層操作的按鍵之後關閉
+  if (pressed && type != ACT_LAYER && !(type == ACT_LAYER_TAP && hold)) {
+    layerOneShotConsume();
+  }
+}
+
+void actionDispatch(byte keyID, bool pressed, uint32_t timeMs) {
+  const uint32_t start = perfNow();
+  //按下時依層堆疊查表並記住，放開時用同一層
+  byte layer;
+  if (pressed) {
+    layer = layersResolve(keyID);
+    setPressLayer(keyID, layer);
+  }
+  else {
+    layer = pressLayer(keyID);
+  }
+  const action_t action = actionAt(layer, keyID);
+  const uint8_t type = ACTION_TYPE(action);
+  const bool hold = actionIsTapHold(action) && isHold(keyID);
+
+  if (pressed) {
+    if (type == ACT_MOUSE) {
+      mouseClickCount++;
+    }
+    else {
+      keyPressCount++;
+    }
+    if ((type == ACT_LAYER && ACTION_PARAM(action) == LAYER_OP_MOMENTARY) ||
+        (type == ACT_LAYER_TAP && hold)) {
+      fnPressCount++;
+    }
+    lastKeyId = keyID;
+    lastKeyLayer = layer;
+    telemetryDirty = true;
+  }
+
+  TRACE(pressed ? TRACE_KEY_DOWN : TRACE_KEY_UP, keyID, layer, action);
+
+  runAction(action, pressed, hold);
+  perfRecord(PERF_DISPATCH, perfNow() - start);
+
+  keyboardRecord(keyID, pressed, layer, timeMs);
+}
+
+void actionExecute(action_t action, bool pressed) {
+  if (pressed) {
+    if (ACTION_TYPE(action) == ACT_MOUSE) {
+      mouseClickCount++;
+    }
+    else {
+      keyPressCount++;
+    }
+    telemetryDirty = true;
+  }
+  runAction(action, pressed, false);
+}
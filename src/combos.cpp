@@ -0,0 +1,164 @@
+//組合鍵判定：暫存可能成為組合的按下，湊成組合就送出組合的動作，否則依序放行
+
+#include "combos.h"
+#include "progmem.h"
+#include "taphold.h"
+#include "stats.h"
+#include "config.h"
+#include "keyboard.h"
+
+#define COMBO_ACTIVE 2  //同時按住的已觸發組合（單手最多兩組兩鍵組合）
+
+//已觸發的組合：第一個鍵放開時放開組合的動作，其餘鍵的放開不再往下送
+struct ActiveCombo {
+  uint64_t held;
+  action_t action;
+  bool down;
+  byte layer;  //觸發時的層級，鍵放開時以同一層記錄
+};
+
+static uint64_t comboKeys;  //所有組合用到的鍵
+static uint64_t pendingMask;
+static uint8_t pendingKeys[COMBO_MAX_KEYS];
+static uint16_t pendingTimes[COMBO_MAX_KEYS];  //各鍵實際按下的時間（低 16 位）
+static uint8_t pendingCount;
+static uint16_t pendingSince;
+static ActiveCombo active[COMBO_ACTIVE];
+
+static uint64_t comboMask(uint8_t i) {
+  return pgmRead(&combos[i].keys);
+}
+
+void combosInit() {
+  comboKeys = 0;
+  for (uint8_t i = 0; i < comboCount; i++) {
+    comboKeys |= comboMask(i);
+  }
+}
+
+enum : uint8_t {
+  MATCH_EXACT = 1,  //有組合恰好是這些鍵
+  MATCH_MORE = 2,   //有組合包含這些鍵再加上其他鍵
+};
+
+//目前層級中包含 mask 的組合；恰好相符時由 exact 傳回索引
+static uint8_t match(uint64_t mask, uint8_t* exact) {
+  const layer_mask_t layerBit = (layer_mask_t)1 << currentLayer;
+  uint8_t result = 0;
+  for (uint8_t i = 0; i < comboCount; i++) {
+    if (!(pgmRead(&combos[i].layers) & layerBit)) {
+      continue;
+    }
+    const uint64_t keys = comboMask(i);
+    if ((keys & mask) != mask) {
+      continue;
+    }
+    if (keys == mask) {
+      result |= MATCH_EXACT;
+      *exact = i;
+    }
+    else {
+      result |= MATCH_MORE;
+    }
+  }
+  return result;
+}
+
+//還原暫存的 16 位元按下時間
+static uint32_t pendingTime(uint8_t i, uint32_t nowMs) {
+  return nowMs - (uint16_t)((uint16_t)nowMs - pendingTimes[i]);
+}
+
+static void fire(uint8_t i, uint32_t nowMs) {
+  const action_t action = pgmRead(&combos[i].action);
+  actionExecute(action, true);
+  //組合用掉的鍵不會再派送，在這裡以組合所在的層記錄
+  for (uint8_t k = 0; k < pendingCount; k++) {
+    keyboardRecord(pendingKeys[k], true, currentLayer, pendingTime(k, nowMs));
+  }
+  for (uint8_t s = 0; s < COMBO_ACTIVE; s++) {
+    if (!active[s].held) {
+      active[s] = { pendingMask, action, true, currentLayer };
+      return;
+    }
+  }
+  //沒有空位（不應發生）：點一下就放開，鍵的放開照常往下送
+  actionExecute(action, false);
+}
+
+//結束暫存：恰好湊成組合就觸發，否則把暫存的按下依原順序放行
+static void resolve(uint32_t nowMs) {
+  uint8_t exact;
+  if (match(pendingMask, &exact) & MATCH_EXACT) {
+    fire(exact, nowMs);
+  }
+  else {
+    for (uint8_t i = 0; i < pendingCount; i++) {
+      tapHoldEvent(pendingKeys[i], true, pendingTime(i, nowMs));
+    }
+  }
+  pendingMask = 0;
+  pendingCount = 0;
+}
+
+void comboEvent(byte keyID, bool pressed, uint32_t nowMs) {
+  const uint64_t bit = KEYBIT(keyID);
+
+  if (!pressed) {
+    for (uint8_t s = 0; s < COMBO_ACTIVE; s++) {
+      if (active[s].held & bit) {
+        active[s].held &= ~bit;
+        keyboardRecord(keyID, false, active[s].layer, nowMs);
+        if (active[s].down) {
+          active[s].down = false;
+          actionExecute(active[s].action, false);
+        }
+        return;
+      }
+    }
+    //暫存中的鍵放開：先判定（可能觸發組合），再處理這次放開
+    if (pendingMask & bit) {
+      resolve(nowMs);
+      comboEvent(keyID, false, nowMs);
+      return;
+    }
+    tapHoldEvent(keyID, false, nowMs);
+    return;
+  }
+
+  if (!pendingMask && !(comboKeys & bit)) {
+    tapHoldEvent(keyID, true, nowMs);
+    return;
+  }
+  const uint64_t mask = pendingMask | bit;
+  uint8_t exact;
+  const uint8_t result = match(mask, &exact);
+  if (!result) {
+    //湊不成任何組合：先了結暫存的鍵，這個鍵再重新判斷一次
+    if (pendingMask) {
+      resolve(nowMs);
+      comboEvent(keyID, true, nowMs);
+    }
+    else {
+      tapHoldEvent(keyID, true, nowMs);
+    }
+    return;
+  }
+
+  if (!pendingMask) {
+    pendingSince = (uint16_t)nowMs;
+  }
+  pendingMask = mask;
+  pendingTimes[pendingCount] = (uint16_t)nowMs;
+  pendingKeys[pendingCount++] = keyID;
+  //沒有更大的組合可等就立即觸發，不必等到時間窗結束
+  if (result == MATCH_EXACT || pendingCount == COMBO_MAX_KEYS) {
+    resolve(nowMs);
+  }
+}
+
+void comboUpdate(uint32_t nowMs) {
+  if (pendingMask && (uint16_t)((uint16_t)nowMs - pendingSince) >= COMBO_TERM_MS) {
+    resolve(nowMs);
+  }
+}
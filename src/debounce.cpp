@@ -0,0 +1,135 @@
+//逐鍵防彈跳
+//每個鍵一個位元組的計時器，只處理「原始狀態與輸出不同」或「計時中」的鍵，
+//閒置時每次掃描只需比較 8 個位元組。
+
+#include "debounce.h"
+
+#if DEBOUNCE_MS > 127
+#error "DEBOUNCE_MS must be <= 127"
+#endif
+
+//計時器最高位：按下後的鎖定期（DEBOUNCE_EAGER_PRESS 使用）
+#define TIMER_LOCKOUT 0x80
+
+static matrix_t debounced;
+static matrix_t pending;
+static uint8_t timers[INPUT_COUNT];
+static unsigned long lastUpdateMs;
+
+static inline uint8_t countDown(uint8_t left, uint8_t elapsed) {
+  return (left > elapsed) ? (uint8_t)(left - elapsed) : 0;
+}
+
+static inline void finish(byte k, byte r, uint8_t bit) {
+  timers[k] = 0;
+  pending.rows[r] &= ~bit;
+}
+
+#if OHK_DEBOUNCE == DEBOUNCE_EAGER_PRESS
+//按下：立刻回報並鎖定 DEBOUNCE_MS，鎖定期間忽略彈跳
+//放開：原始狀態持續放開 DEBOUNCE_MS 後才回報，期間又按下則取消
+static void updateKey(byte k, byte r, uint8_t bit, bool rawOn, uint8_t elapsed) {
+  const uint8_t t = timers[k];
+  if (t & TIMER_LOCKOUT) {
+    const uint8_t left = countDown(t & ~TIMER_LOCKOUT, elapsed);
+    if (left) timers[k] = TIMER_LOCKOUT | left;
+    else finish(k, r, bit);
+    return;
+  }
+  if (t) {
+    if (rawOn) {
+      finish(k, r, bit);
+      return;
+    }
+    const uint8_t left = countDown(t, elapsed);
+    if (left) {
+      timers[k] = left;
+      return;
+    }
+    debounced.rows[r] &= ~bit;
+    finish(k, r, bit);
+    return;
+  }
+
+  if (rawOn == (bool)(debounced.rows[r] & bit)) {
+    return;
+  }
+  if (rawOn) {
+    debounced.rows[r] |= bit;
+    timers[k] = TIMER_LOCKOUT | DEBOUNCE_MS;
+  }
+  else {
+    timers[k] = DEBOUNCE_MS;
+  }
+  pending.rows[r] |= bit;
+}
+
+#elif OHK_DEBOUNCE == DEBOUNCE_SYM_DEFER
+//按下與放開都要求新狀態穩定 DEBOUNCE_MS，中途彈回則重新計時
+static void updateKey(byte k, byte r, uint8_t bit, bool rawOn, uint8_t elapsed) {
+  const uint8_t t = timers[k];
+  if (rawOn == (bool)(debounced.rows[r] & bit)) {
+    if (t) finish(k, r, bit);
+    return;
+  }
+  if (!t) {
+    timers[k] = DEBOUNCE_MS;
+    pending.rows[r] |= bit;
+    return;
+  }
+  const uint8_t left = countDown(t, elapsed);
+  if (left) {
+    timers[k] = left;
+    return;
+  }
+  debounced.rows[r] ^= bit;
+  finish(k, r, bit);
+}
+
+#elif OHK_DEBOUNCE == DEBOUNCE_COUNTER
+//積分計數器：讀值與輸出不同時累加經過的毫秒，相同時遞減，累積滿 DEBOUNCE_MS 才切換
+static void updateKey(byte k, byte r, uint8_t bit, bool rawOn, uint8_t elapsed) {
+  const uint8_t t = timers[k];
+  if (rawOn == (bool)(debounced.rows[r] & bit)) {
+    const uint8_t left = countDown(t, elapsed);
+    if (left) timers[k] = left;
+    else finish(k, r, bit);
+    return;
+  }
+  pending.rows[r] |= bit;
+  const uint16_t sum = (uint16_t)t + elapsed;
+  if (sum < DEBOUNCE_MS) {
+    timers[k] = (uint8_t)sum;
+    return;
+  }
+  debounced.rows[r] ^= bit;
+  finish(k, r, bit);
+}
+
+#else
+#error "Unknown OHK_DEBOUNCE"
+#endif
+
+void debounceInit() {
+  debounced.word = 0;
+  pending.word = 0;
+  memset(timers, 0, sizeof(timers));
+  lastUpdateMs = millis();
+}
+
+const matrix_t& debounceUpdate(const matrix_t& raw, unsigned long nowMs) {
+  const unsigned long dt = nowMs - lastUpdateMs;
+  const uint8_t elapsed = (dt > 255) ? 255 : (uint8_t)dt;
+  lastUpdateMs = nowMs;
+
+  for (byte r = 0; r < sizeof(raw.rows); r++) {
+    uint8_t active = (raw.rows[r] ^ debounced.rows[r]) | pending.rows[r];
+    for (byte c = 0; active; c++, active >>= 1) {
+      if (active & 1) {
+        const uint8_t bit = (uint8_t)(1 << c);
+        updateKey((byte)(r * COLS + c), r, bit, raw.rows[r] & bit, elapsed);
+      }
+    }
+  }
+  return debounced;
+}
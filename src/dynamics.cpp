@@ -0,0 +1,173 @@
+//打字動態統計
+
+#include <util/atomic.h>
+#include "dynamics.h"
+
+#define HELD_FREE 0xFF
+
+static_assert(DYN_WPM_SLOTS * DYN_WPM_SLOT_MS == 60000UL, "WPM window must be one minute");
+
+//按住中的鍵：放開時算出按住時間
+struct HeldKey {
+  uint8_t keyID;  //HELD_FREE 為未使用
+  uint8_t layer;
+  uint16_t since;
+};
+
+static DynamicsTable table;
+static HeldKey held[DYN_HELD];
+static uint32_t lastPressMs;
+static bool hasLastPress;
+
+//WPM：每格 DYN_WPM_SLOT_MS 內的按下次數，wpmHead 為目前這格
+static uint8_t wpmSlots[DYN_WPM_SLOTS];
+static uint8_t wpmHead;
+static uint32_t wpmSlotStart;
+
+//主機命令（USB 中斷寫入，下次記錄時處理）
+static volatile uint16_t readOffset;
+static volatile bool clearRequested;
+
+static void clearAll(uint32_t nowMs) {
+  memset(&table, 0, sizeof(table));
+  table.dwellShift = DYN_DWELL_SHIFT;
+  table.flightShift = DYN_FLIGHT_SHIFT;
+  for (uint8_t i = 0; i < DYN_HELD; i++) {
+    held[i].keyID = HELD_FREE;
+  }
+  hasLastPress = false;
+  memset(wpmSlots, 0, sizeof(wpmSlots));
+  wpmHead = 0;
+  wpmSlotStart = nowMs;
+}
+
+void dynamicsInit() {
+  clearAll(millis());
+  readOffset = 0;
+  clearRequested = false;
+}
+
+static void histogramAdd(DynHistogram& h, uint16_t ms, uint8_t shift) {
+  uint16_t b = ms >> shift;
+  if (b >= DYN_BUCKETS) {
+    b = DYN_BUCKETS - 1;
+  }
+  if (h.buckets[b] == 0xFF) {
+    for (uint8_t i = 0; i < DYN_BUCKETS; i++) {
+      h.buckets[i] >>= 1;
+    }
+    if (h.scale < 0xFF) {
+      h.scale++;
+    }
+  }
+  h.buckets[b]++;
+}
+
+//換到 nowMs 所在的格子，跳過的格子清為 0
+static void wpmAdvance(uint32_t nowMs) {
+  //判定後才派送的按下帶著原本的時間，可能早於目前這格的起點：算在目前這格
+  if ((int32_t)(nowMs - wpmSlotStart) < 0) {
+    return;
+  }
+  for (uint8_t n = 0; nowMs - wpmSlotStart >= DYN_WPM_SLOT_MS; n++) {
+    if (n == DYN_WPM_SLOTS) {
+      //整個視窗都已過期
+      wpmSlotStart = nowMs;
+      break;
+    }
+    wpmSlotStart += DYN_WPM_SLOT_MS;
+    wpmHead = (wpmHead + 1) % DYN_WPM_SLOTS;
+    wpmSlots[wpmHead] = 0;
+  }
+}
+
+static void record(uint8_t keyID, bool pressed, uint8_t layer, uint32_t nowMs) {
+  if (clearRequested) {
+    clearRequested = false;
+    clearAll(nowMs);
+  }
+
+  if (pressed) {
+    if (hasLastPress && nowMs - lastPressMs <= DYN_FLIGHT_MAX_MS) {
+      histogramAdd(table.flight[layer], (uint16_t)(nowMs - lastPressMs), DYN_FLIGHT_SHIFT);
+    }
+    lastPressMs = nowMs;
+    hasLastPress = true;
+
+    for (uint8_t i = 0; i < DYN_HELD; i++) {
+      if (held[i].keyID == HELD_FREE) {
+        held[i] = { keyID, layer, (uint16_t)nowMs };
+        break;
+      }
+    }
+
+    wpmAdvance(nowMs);
+    if (wpmSlots[wpmHead] != 0xFF) {
+      wpmSlots[wpmHead]++;
+    }
+    return;
+  }
+
+  for (uint8_t i = 0; i < DYN_HELD; i++) {
+    if (held[i].keyID != keyID) {
+      continue;
+    }
+    held[i].keyID = HELD_FREE;
+    const uint16_t dwell = (uint16_t)nowMs - held[i].since;
+    histogramAdd(table.dwell[held[i].layer], dwell, DYN_DWELL_SHIFT);
+
+    //移動平均：avg += (dwell - avg) / 8（四捨五入），第一筆直接採用
+    const int16_t sample = (dwell > 0xFF) ? 0xFF : (int16_t)dwell;
+    uint8_t& avg = table.keyDwell[keyID];
+    avg = avg ? (uint8_t)(avg + ((sample - avg + 4) >> 3)) : (uint8_t)sample;
+    return;
+  }
+}
+
+void dynamicsRecord(uint8_t keyID, bool pressed, uint8_t layer, uint32_t nowMs) {
+  //USB 中斷會讀取 table 與 WPM 格子（含 32-bit 的 wpmSlotStart），
+  //整筆更新（含直方圖減半、清除）不讓中斷插入，讀到的永遠是完整的一份
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    record(keyID, pressed, layer, nowMs);
+  }
+}
+
+//最近一分鐘的按下次數 / 5，x10；讀取時才加總，已過期的格子不算
+static uint16_t wpmX10(uint32_t nowMs) {
+  const uint32_t stale = (nowMs - wpmSlotStart) / DYN_WPM_SLOT_MS;
+  uint16_t presses = 0;
+  for (uint8_t age = 0; age + stale < DYN_WPM_SLOTS; age++) {
+    presses += wpmSlots[(wpmHead + DYN_WPM_SLOTS - age) % DYN_WPM_SLOTS];
+  }
+  return presses * 2;
+}
+
+void dynamicsFillChunk(DynamicsChunk& chunk) {
+  memset(&chunk, 0, sizeof(chunk));
+  uint16_t offset = readOffset;
+  if (offset > sizeof(table)) {
+    offset = sizeof(table);
+  }
+  const uint16_t remain = sizeof(table) - offset;
+  chunk.version = DYN_REPORT_VERSION;
+  chunk.length = (remain > DYN_CHUNK_SIZE) ? DYN_CHUNK_SIZE : remain;
+  chunk.offset = offset;
+  chunk.total = sizeof(table);
+  //清除要等下次記錄時才在主迴圈執行，在那之前回傳全 0
+  if (clearRequested) {
+    return;
+  }
+  chunk.wpmX10 = wpmX10(millis());
+  memcpy(chunk.data, (const uint8_t*)&table + offset, chunk.length);
+}
+
+void dynamicsCommand(uint8_t cmd, uint16_t arg) {
+  switch (cmd) {
+    case DYN_CMD_SELECT:
+      readOffset = arg;
+      break;
+    case DYN_CMD_CLEAR:
+      clearRequested = true;
+      break;
+  }
+}
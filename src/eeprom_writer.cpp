@@ -0,0 +1,47 @@
+//EEPROM 背景寫入
+
+#include <avr/eeprom.h>
+#include "eeprom_writer.h"
+
+static const uint8_t* segData[2];
+static uint16_t segAddr[2];
+static uint16_t segLen[2];
+static uint8_t seg = 2;   //目前寫到第幾段（2 為沒有工作）
+static uint16_t pos;
+
+bool eepromWriterStart(uint16_t dataAddr, const void* data, uint16_t dataLen,
+                       uint16_t headerAddr, const void* header, uint8_t headerLen) {
+  if (eepromWriterBusy()) {
+    return false;
+  }
+  segData[0] = (const uint8_t*)data;
+  segAddr[0] = dataAddr;
+  segLen[0] = dataLen;
+  segData[1] = (const uint8_t*)header;
+  segAddr[1] = headerAddr;
+  segLen[1] = headerLen;
+  seg = 0;
+  pos = 0;
+  return true;
+}
+
+bool eepromWriterBusy() {
+  return seg < 2;
+}
+
+void eepromWriterUpdate() {
+  //內容相同的 byte 直接略過，不同的寫入一個就返回
+  while (seg < 2 && eeprom_is_ready()) {
+    if (pos >= segLen[seg]) {
+      seg++;
+      pos = 0;
+      continue;
+    }
+    uint8_t* addr = (uint8_t*)(uintptr_t)(segAddr[seg] + pos);
+    const uint8_t value = segData[seg][pos++];
+    if (eeprom_read_byte(addr) != value) {
+      eeprom_write_byte(addr, value);
+      return;
+    }
+  }
+}
@@ -0,0 +1,67 @@
+//旋鈕中斷解碼
+//與 RotaryEncoder 的 LatchMode::TWO03 相同：以狀態表累加四分之一段，
+//回到 00 或 11 時才算一段。中斷是唯一的寫入者，只發布一個位元組的段數，
+//主迴圈讀單一位元組不需關中斷。
+
+#include "config.h"
+#include "encoder.h"
+#include "progmem.h"
+
+//(舊狀態 << 2 | 新狀態) -> 方向，無效的跳變為 0
+static const int8_t KNOBDIR[16] PROGMEM = {
+  0, -1, 1, 0,
+  1, 0, 0, -1,
+  -1, 0, 0, 1,
+  0, 1, -1, 0
+};
+
+static uint8_t oldState;
+//四分之一段的計數：無號數讓長時間往同一方向轉時自然繞回（有號溢位是未定義行為），
+//段數只取 bit1..8，繞回前後的差值不變
+static uint16_t quarterSteps;
+static volatile uint8_t detents;
+static uint8_t detentsRead;
+
+//DT = PD2（bit0）、CLK = PD3（bit1）
+static inline uint8_t readState() {
+  return (PIND >> 2) & 0x03;
+}
+
+ISR(INT2_vect) {
+  const uint8_t state = readState();
+  if (state == oldState) {
+    return;
+  }
+  quarterSteps += (uint16_t)pgmRead(&KNOBDIR[state | (oldState << 2)]);
+  oldState = state;
+  if (state == 0 || state == 3) {
+    detents = (uint8_t)(quarterSteps >> 1);
+  }
+}
+
+ISR(INT3_vect, ISR_ALIASOF(INT2_vect));
+
+void encoderInit() {
+  pinMode(DT_PIN, INPUT_PULLUP);
+  pinMode(CLK_PIN, INPUT_PULLUP);
+  oldState = readState();
+  quarterSteps = 0;
+  detents = 0;
+  detentsRead = 0;
+
+  //INT2 / INT3 任一邊緣觸發
+  EICRA = (EICRA & ~(_BV(ISC21) | _BV(ISC31))) | _BV(ISC20) | _BV(ISC30);
+  EIFR = _BV(INTF2) | _BV(INTF3);
+  EIMSK |= _BV(INT2) | _BV(INT3);
+}
+
+int8_t encoderTakeDelta() {
+  const uint8_t now = detents;
+  const int8_t delta = (int8_t)(now - detentsRead);
+  detentsRead = now;
+  return delta;
+}
+
+bool encoderMoved() {
+  return detents != detentsRead;
+}
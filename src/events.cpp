@@ -0,0 +1,107 @@
+//按鍵事件串流
+
+#include <util/atomic.h>
+#include "events.h"
+#include "usb_hid.h"
+
+#define EVENTS_MASK (EVENTS_RING - 1)
+
+static KeyEvent ring[EVENTS_RING];
+static uint16_t headSeq;   //下一筆寫入的序號
+static uint16_t sendSeq;   //下一筆要送的序號（USB 中斷會讀取，以 setSendSeq 寫入）
+static uint8_t stored;     //緩衝區內的筆數（最多 EVENTS_RING）
+static bool resync;
+static unsigned long lastSentMs;
+
+//由 USB 中斷寫入，主迴圈取走
+static volatile bool retransmitPending;
+static volatile uint16_t retransmitSeq;
+
+static void setSendSeq(uint16_t seq) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    sendSeq = seq;
+  }
+}
+
+void eventsInit() {
+  headSeq = 0;
+  sendSeq = 0;
+  stored = 0;
+  resync = false;
+  lastSentMs = 0;
+  retransmitPending = false;
+}
+
+void eventsRecord(uint8_t keyID, bool pressed, uint8_t layer, unsigned long nowMs) {
+  KeyEvent& e = ring[headSeq & EVENTS_MASK];
+  e.timeMs = (uint16_t)nowMs;
+  e.keyID = keyID;
+  e.info = (pressed ? EVENT_INFO_PRESSED : 0) | (layer & EVENT_INFO_LAYER_MASK);
+  headSeq++;
+  if (stored < EVENTS_RING) {
+    stored++;
+  }
+  //主機太久沒收（例如未連線），未送出的最舊一筆被覆蓋
+  if ((uint16_t)(headSeq - sendSeq) > EVENTS_RING) {
+    setSendSeq(headSeq - EVENTS_RING);
+    resync = true;
+  }
+}
+
+static void applyRetransmit() {
+  bool pending;
+  uint16_t from;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    pending = retransmitPending;
+    from = retransmitSeq;
+    retransmitPending = false;
+  }
+  if (!pending) {
+    return;
+  }
+  const uint16_t behind = headSeq - from;
+  if (behind <= stored) {
+    setSendSeq(from);
+  }
+  else if (behind < 0x8000) {
+    //已被覆蓋：從還留著的最舊一筆開始，並告知主機
+    setSendSeq(headSeq - stored);
+    resync = true;
+  }
+  //序號在未來：主機狀態錯亂，忽略
+}
+
+void eventsUpdate(unsigned long nowMs) {
+  applyRetransmit();
+  if (sendSeq == headSeq || (nowMs - lastSentMs) < EVENTS_MIN_INTERVAL_MS) {
+    return;
+  }
+
+  EventReport report;
+  memset(&report, 0, sizeof(report));
+  uint16_t pending = headSeq - sendSeq;
+  report.version = EVENTS_VERSION;
+  report.count = (pending > EVENTS_PER_REPORT) ? EVENTS_PER_REPORT : pending;
+  report.flags = resync ? EVENTS_FLAG_RESYNC : 0;
+  report.firstSeq = sendSeq;
+  report.headSeq = headSeq;
+  for (uint8_t i = 0; i < report.count; i++) {
+    report.events[i] = ring[(uint16_t)(sendSeq + i) & EVENTS_MASK];
+  }
+
+  if (UsbHid.sendReport(USB_HID_REPORTID_EVENTS, &report, sizeof(report)) < 0) {
+    return;
+  }
+  setSendSeq(sendSeq + report.count);
+  resync = false;
+  lastSentMs = nowMs;
+}
+
+void eventsRequestRetransmit(uint16_t seq) {
+  retransmitSeq = seq;
+  retransmitPending = true;
+}
+
+uint16_t eventsSendStart() {
+  return retransmitPending ? retransmitSeq : sendSeq;
+}
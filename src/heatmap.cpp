@@ -0,0 +1,224 @@
+//按鍵熱度表
+
+#include <avr/eeprom.h>
+#include <util/atomic.h>
+#include <util/crc16.h>
+#include "heatmap.h"
+#include "eeprom_layout.h"
+#include "eeprom_writer.h"
+#include "progmem.h"
+
+#define HEAT_MAGIC 0x48
+
+//每個槽：標頭在前、熱度表在後；標頭最後寫入，CRC 對得上才算有效
+struct __attribute__((packed)) HeatSlotHeader {
+  uint8_t magic;
+  uint8_t seq;    //較新的槽序號較大（以 8-bit 差值比較）
+  uint16_t crc;   //熱度表的 CRC16
+};
+
+static_assert(sizeof(HeatSlotHeader) + sizeof(HeatTable) <= EEPROM_HEAT_SLOT_SIZE, "heat slot too small");
+
+static const uint16_t slotAddr[2] PROGMEM = { EEPROM_HEAT_SLOT_A, EEPROM_HEAT_SLOT_B };
+
+static HeatTable table;
+static uint8_t currentSlot;   //最近一次有效寫入的槽
+static uint8_t currentSeq;
+static bool dirty;
+static unsigned long lastPressMs;
+static unsigned long lastFlushMs;
+
+//寫入中（由 eeprom_writer 在背景寫入）與要寫入的標頭
+static bool flushing;
+static HeatSlotHeader flushHeader;
+
+//寫入中的按鍵先排隊，寫完再計入，讓寫入的內容與 CRC 一致
+#define HEAT_QUEUE 16
+static uint8_t queue[HEAT_QUEUE];
+static uint8_t queueLen;
+
+//主機命令（USB 中斷寫入，主迴圈處理）
+static volatile uint16_t readOffset;
+static volatile bool flushRequested;
+static volatile bool clearRequested;
+
+static uint16_t tableCrc() {
+  uint16_t crc = 0xFFFF;
+  const uint8_t* p = (const uint8_t*)&table;
+  for (uint16_t i = 0; i < sizeof(table); i++) {
+    crc = _crc16_update(crc, p[i]);
+  }
+  return crc;
+}
+
+//USB 中斷會讀取 table：清除與進位（increment）都不讓中斷插入
+static void clearTable() {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    memset(table.low, 0, sizeof(table.low));
+    memset(table.overflow, HEAT_OVERFLOW_FREE, sizeof(table.overflow));
+  }
+}
+
+//讀出槽的標頭並檢查內容；有效時熱度表留在 table 中
+static bool loadSlot(uint8_t slot, HeatSlotHeader& header) {
+  eeprom_read_block(&header, (const void*)(uintptr_t)pgmRead(&slotAddr[slot]), sizeof(header));
+  if (header.magic != HEAT_MAGIC) {
+    return false;
+  }
+  eeprom_read_block(&table, (const void*)(uintptr_t)(pgmRead(&slotAddr[slot]) + sizeof(header)), sizeof(table));
+  return tableCrc() == header.crc;
+}
+
+void heatInit() {
+  HeatSlotHeader a, b;
+  const bool validA = loadSlot(0, a);
+  const bool validB = loadSlot(1, b);
+  if (validA && (!validB || (int8_t)(a.seq - b.seq) > 0)) {
+    loadSlot(0, a);
+    currentSlot = 0;
+    currentSeq = a.seq;
+  }
+  else if (validB) {
+    //table 目前就是 B 的內容
+    currentSlot = 1;
+    currentSeq = b.seq;
+  }
+  else {
+    clearTable();
+    currentSlot = 1;
+    currentSeq = 0;
+  }
+  dirty = false;
+  flushing = false;
+  queueLen = 0;
+  lastPressMs = 0;
+  //第一次寫入不等間隔，停止打字就寫：插上後不久拔掉也不會丟掉全部計數
+  lastFlushMs = millis() - HEAT_FLUSH_INTERVAL_MS;
+}
+
+static void increment(uint8_t index) {
+  if (table.low[index] != 0xFF) {
+    table.low[index]++;
+    return;
+  }
+  //低位滿了：找這個計數器的高位，沒有就配置一個
+  HeatOverflow* slot = NULL;
+  for (uint8_t i = 0; i < HEAT_OVERFLOW_COUNT; i++) {
+    if (table.overflow[i].index == index) {
+      slot = &table.overflow[i];
+      break;
+    }
+    if (!slot && table.overflow[i].index == HEAT_OVERFLOW_FREE) {
+      slot = &table.overflow[i];
+    }
+  }
+  //高位用完或已達上限：停在最大值
+  if (!slot || (slot->index == index && slot->high == 0xFFFF)) {
+    return;
+  }
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (slot->index != index) {
+      slot->index = index;
+      slot->high = 0;
+    }
+    slot->high++;
+    table.low[index] = 0;
+  }
+}
+
+void heatCount(uint8_t keyID, uint8_t layer) {
+  if (keyID >= KEY_COUNT || layer >= LAYER_COUNT) {
+    return;
+  }
+  const uint8_t index = layer * KEY_COUNT + keyID;
+  lastPressMs = millis();
+  dirty = true;
+  if (flushing) {
+    if (queueLen < HEAT_QUEUE) {
+      queue[queueLen++] = index;
+    }
+    return;
+  }
+  increment(index);
+}
+
+static bool startFlush() {
+  flushHeader.magic = HEAT_MAGIC;
+  flushHeader.seq = currentSeq + 1;
+  flushHeader.crc = tableCrc();
+  const uint16_t base = pgmRead(&slotAddr[currentSlot ^ 1]);
+  if (!eepromWriterStart(base + sizeof(HeatSlotHeader), &table, sizeof(table),
+                         base, &flushHeader, sizeof(flushHeader))) {
+    return false;
+  }
+  flushing = true;
+  dirty = false;
+  return true;
+}
+
+//寫入完成：切換到新槽，補上寫入中排隊的按鍵
+static void finishFlush(unsigned long nowMs) {
+  currentSlot ^= 1;
+  currentSeq = flushHeader.seq;
+  flushing = false;
+  lastFlushMs = nowMs;
+  for (uint8_t i = 0; i < queueLen; i++) {
+    increment(queue[i]);
+  }
+  queueLen = 0;
+}
+
+void heatUpdate(unsigned long nowMs) {
+  if (flushing) {
+    if (!eepromWriterBusy()) {
+      finishFlush(nowMs);
+    }
+    return;
+  }
+  if (clearRequested) {
+    //EEPROM 正被其他模組寫入時下次再試
+    clearTable();
+    if (startFlush()) {
+      clearRequested = false;
+    }
+    return;
+  }
+  if (!dirty) {
+    flushRequested = false;
+    return;
+  }
+  if (flushRequested
+      || ((nowMs - lastPressMs) >= HEAT_FLUSH_IDLE_MS && (nowMs - lastFlushMs) >= HEAT_FLUSH_INTERVAL_MS)) {
+    if (startFlush()) {
+      flushRequested = false;
+    }
+  }
+}
+
+void heatFillChunk(HeatChunk& chunk) {
+  memset(&chunk, 0, sizeof(chunk));
+  uint16_t offset = readOffset;
+  if (offset > sizeof(table)) {
+    offset = sizeof(table);
+  }
+  const uint16_t remain = sizeof(table) - offset;
+  chunk.version = HEAT_REPORT_VERSION;
+  chunk.length = (remain > HEAT_CHUNK_SIZE) ? HEAT_CHUNK_SIZE : remain;
+  chunk.offset = offset;
+  chunk.total = sizeof(table);
+  memcpy(chunk.data, (const uint8_t*)&table + offset, chunk.length);
+}
+
+void heatCommand(uint8_t cmd, uint16_t arg) {
+  switch (cmd) {
+    case HEAT_CMD_SELECT:
+      readOffset = arg;
+      break;
+    case HEAT_CMD_FLUSH:
+      flushRequested = true;
+      break;
+    case HEAT_CMD_CLEAR:
+      clearRequested = true;
+      break;
+  }
+}
@@ -0,0 +1,138 @@
+//按鍵處理流程：掃描結果經防彈跳、鬼鍵過濾、組合鍵、點按 / 按住判定後派送，
+//再加上旋鈕與巨集，合成一份回報。只透過 matrix / encoder / report / perf 的介面
+//接觸硬體，原生模擬（src/native/）換掉這幾個模組即可在電腦上執行。
+
+#include <HID-Project.h>
+#include "keyboard.h"
+#include "config.h"
+#include "actions.h"
+#include "stats.h"
+#include "matrix.h"
+#include "debounce.h"
+#include "report.h"
+#include "encoder.h"
+#include "scroll.h"
+#include "perf.h"
+#include "events.h"
+#include "heatmap.h"
+#include "keymap_store.h"
+#include "layers.h"
+#include "taphold.h"
+#include "combos.h"
+#include "macros.h"
+#include "dynamics.h"
+
+//上次回報的（防彈跳後）狀態
+static matrix_t matrixPrev;
+static uint32_t lastActivityMs;
+static uint32_t lastScanStart;
+static bool scanRestart;  //沒有上一次掃描可比較（開機、閒置結束）
+
+//目前層級
+byte currentLayer = 0;
+
+//HID 監控用統計資料
+uint32_t keyPressCount = 0;
+uint32_t fnPressCount = 0;
+uint32_t encoderTurnCount = 0;
+uint32_t mouseClickCount = 0;
+uint8_t lastKeyId = 0;
+uint8_t lastKeyLayer = 0;
+bool telemetryDirty = true;
+
+void keyboardRecord(byte keyID, bool pressed, byte layer, uint32_t timeMs) {
+  eventsRecord(keyID, pressed, layer, timeMs);
+  if (pressed) {
+    heatCount(keyID, layer);
+  }
+  if (keyID < KEY_COUNT) {
+    dynamicsRecord(keyID, pressed, layer, timeMs);
+  }
+}
+
+static void inputEvent(byte keyID, bool pressed) {
+  //旋鈕按鍵：不查表，以目前層級記錄，按下時送出滑鼠中鍵點擊
+  if (keyID == ENC_SW_KEY_ID) {
+    keyboardRecord(keyID, pressed, currentLayer, millis());
+    if (pressed) {
+      reportMousePress(MOUSE_MIDDLE);
+      reportMouseRelease(MOUSE_MIDDLE);
+      mouseClickCount++;
+      telemetryDirty = true;
+    }
+    return;
+  }
+  //矩陣按鍵要等組合鍵與點按 / 按住判定後才知道查哪一層，在派送時才記錄（keyboardRecord）
+  comboEvent(keyID, pressed, millis());
+}
+
+void keyboardInit() {
+  debounceInit();
+  scrollInit();
+  keymapInit();
+  layersInit();
+  combosInit();
+  dynamicsInit();
+  matrixPrev.word = 0;
+  lastActivityMs = millis();
+  scanRestart = true;
+}
+
+void keyboardScan() {
+  //掃描週期
+  const uint32_t scanStart = perfNow();
+  if (!scanRestart) {
+    perfRecord(PERF_LOOP, scanStart - lastScanStart);
+  }
+  scanRestart = false;
+  lastScanStart = scanStart;
+
+  //掃描矩陣並逐鍵防彈跳、濾掉鬼鍵，與上次狀態 XOR 找出有變化的鍵
+  const matrix_t& raw = matrixScan();
+  perfRecord(PERF_MATRIX, perfNow() - scanStart);
+  const matrix_t& m = matrixGhostFilter(debounceUpdate(raw, millis()), matrixPrev);
+  perfRecord(PERF_SCAN, perfNow() - scanStart);
+  //先處理逾時的組合鍵與點按 / 按住判定，再派送這次掃描的新事件
+  comboUpdate(millis());
+  tapHoldUpdate(millis());
+  if (m.word != matrixPrev.word) {
+    perfMarkEvent(scanStart);
+    lastActivityMs = millis();
+    for (byte r = 0; r < sizeof(m.rows); r++) {
+      uint8_t diff = m.rows[r] ^ matrixPrev.rows[r];
+      for (byte c = 0; diff; c++, diff >>= 1) {
+        if (diff & 1) {
+          inputEvent((byte)(r * COLS + c), (m.rows[r] >> c) & 1);
+        }
+      }
+    }
+    matrixPrev = m;
+  }
+
+  //旋鈕滾動（上/下）：中斷已累積好段數，這裡只取出差值交給滾動加速
+  const int8_t delta = encoderTakeDelta();
+  if (delta != 0) {
+    lastActivityMs = millis();
+    scrollDetents(delta, millis());
+    encoderTurnCount += (uint32_t)abs(delta);
+    telemetryDirty = true;
+  }
+
+  //巨集在上一步送出後才繼續，與本次掃描的變化合成同一份回報
+  macroUpdate(millis());
+
+  //本次掃描的所有變化合成一份回報送出
+  reportFlush();
+}
+
+bool keyboardQuiet() {
+  return matrixPrev.word == 0 && !macroBusy();
+}
+
+uint32_t keyboardLastActivity() {
+  return lastActivityMs;
+}
+
+void keyboardWake() {
+  scanRestart = true;
+}
@@ -0,0 +1,83 @@
+//預設鍵位表定義（EEPROM 中沒有主機上傳的鍵位表時使用）
+//每格為一個動作碼（見 actions.h），一般鍵直接寫鍵碼即可。
+//Layer 0 / 2 為英文 / 注音基本層，FN 按住時開啟各自的 FN 層（1 / 3）、點按為 Backspace，
+//CTRL 點按為 Esc，英文層的 SHIFT 點按為 Enter（注音層的 SHIFT 保持單純 SHIFT，點按用來切換中英）；
+//LAYER 鍵在 Layer 0 上切換開啟 / 關閉 Layer 2；FN 層中的 LAYER 鍵不作用。
+//滑鼠左右鍵在每一層都有效，因此四層都放同樣的動作。
+
+#include <HID-Project.h>
+#include "actions.h"
+#include "combos.h"
+#include "macros.h"
+
+#define FN_EN    LT(1, KEY_BACKSPACE)
+#define FN_ZH    LT(3, KEY_BACKSPACE)
+#define CTRL_    MT(MOD_CTRL, KEY_ESC)
+#define SHIFT_   MT(MOD_SHIFT, KEY_ENTER)
+#define LAYER_   TG(2)
+#define _______  TRNS
+#define M_LEFT   MS(MOUSE_LEFT)
+#define M_RIGHT  MS(MOUSE_RIGHT)
+
+const action_t actionmaps[LAYER_COUNT][KEY_COUNT] PROGMEM = {
+// Layer 0：英文層（非 FN）
+  { 0,                KEY_TILDE,        KEY_LEFT_BRACE,   KEY_RIGHT_BRACE,  KEY_MINUS,        KEY_EQUAL,        KEY_SEMICOLON,    KEY_BACKSLASH,
+    KEY_ESC,          KEY_6,            KEY_7,            KEY_8,            KEY_9,            KEY_0,            KEY_COMMA,        KEY_PERIOD,
+    KEY_CAPS_LOCK,    KEY_1,            KEY_2,            KEY_3,            KEY_4,            KEY_5,            KEY_SLASH,        KEY_QUOTE,
+    KEY_TAB,          KEY_Y,            KEY_Q,            KEY_W,            KEY_E,            KEY_R,            KEY_T,            KEY_BACKSPACE,
+    SHIFT_,           KEY_H,            KEY_A,            KEY_S,            0x07,             KEY_F,            KEY_G,            KEY_ENTER,
+    FN_EN,            KEY_Z,            KEY_X,            KEY_C,            KEY_V,            KEY_LEFT_ALT,     CTRL_,            LAYER_,
+    M_LEFT,           M_RIGHT,          KEY_SPACE,        0,                0,                0,                0,                0
+  },
+
+// Layer 1：英文層（FN）
+  { 0,                0,                0,                0,                0,                0,                0,                SYS(SYS_NKRO_TOGGLE),
+    KEY_LEFT_WINDOWS, KEY_F7,           KEY_F8,           KEY_F9,           KEY_F10,          KEY_F11,          KEY_F12,          0,
+    KEY_CAPS_LOCK,    KEY_F1,           KEY_F2,           KEY_F3,           KEY_F4,           KEY_F5,           KEY_F6,           0,
+    KEY_TAB,          MK(MOD_GUI, KEY_H), KEY_UP,         KEY_U,            KEY_I,            KEY_O,            KEY_P,            KEY_DELETE,
+    KEY_LEFT_SHIFT,   KEY_LEFT,         KEY_DOWN,         KEY_RIGHT,        KEY_J,            KEY_K,            KEY_L,            KEY_ENTER,
+    _______,          0,                KEY_B,            KEY_N,            KEY_M,            0,                MK(MOD_GUI, KEY_SPACE), 0,
+    M_LEFT,           M_RIGHT,          0,                0,                0,                0,                0,                0
+  },
+
+// Layer 2：注音層（非 FN）
+  { 0,                KEY_1,            KEY_S,            KEY_F,            KEY_Y,            KEY_8,            KEY_L,            KEY_SLASH,
+    KEY_ESC,          KEY_Q,            KEY_X,            KEY_V,            KEY_H,            KEY_I,            KEY_PERIOD,       KEY_MINUS,
+    KEY_CAPS_LOCK,    KEY_A,            KEY_E,            KEY_5,            KEY_N,            KEY_K,            KEY_0,            KEY_TILDE,
+    KEY_TAB,          KEY_Z,            KEY_D,            KEY_T,            KEY_U,            KEY_COMMA,        KEY_P,            KEY_BACKSPACE,
+    KEY_LEFT_SHIFT,   KEY_2,            KEY_C,            KEY_G,            KEY_J,            KEY_9,            KEY_SEMICOLON,    KEY_ENTER,
+    FN_ZH,            KEY_W,            KEY_R,            KEY_B,            KEY_M,            KEY_O,            CTRL_,            LAYER_,
+    M_LEFT,           M_RIGHT,          KEY_SPACE,        0,                0,                0,                0,                0
+  },
+
+// Layer 3：注音層（FN）
+  { 0,                0,                MK(MOD_CTRL, KEY_LEFT_BRACE), MK(MOD_CTRL, KEY_RIGHT_BRACE), 0, 0,          0,                0,
+    KEY_LEFT_WINDOWS, MK(MOD_SHIFT, KEY_3), MK(MOD_SHIFT, KEY_7), MK(MOD_SHIFT, KEY_8), KEY_EQUAL, MK(MOD_SHIFT, KEY_EQUAL), 0, 0,
+    KEY_CAPS_LOCK,    KEY_SPACE,        KEY_6,            KEY_3,            KEY_4,            KEY_7,            MK(MOD_SHIFT, KEY_6), 0,
+    KEY_TAB,          MK(MOD_CTRL, KEY_SEMICOLON), MK(MOD_CTRL, KEY_QUOTE), MK(MOD_CTRL, KEY_COMMA), MK(MOD_CTRL, KEY_PERIOD), 0, 0, KEY_DELETE,
+    KEY_LEFT_SHIFT,   0,                0,                0,                0,                0,                0,                0,
+    _______,          0,                0,                0,                0,                0,                MK(MOD_GUI, KEY_SPACE), 0,
+    M_LEFT,           M_RIGHT,          KEY_SPACE,        0,                0,                0,                0,                0
+  },
+};
+
+//組合鍵：注音層同一行上下相鄰的兩個韻母鍵一起按下，送出全形標點
+//（原本要按 FN 到 Layer 3 才有的 CTRL+, / CTRL+.）或常用詞巨集
+const Combo combos[] PROGMEM = {
+  { COMBO2(22, 30), 1 << 2, MK(MOD_CTRL, KEY_COMMA) },   //ㄢ + ㄣ → ，
+  { COMBO2(14, 22), 1 << 2, MK(MOD_CTRL, KEY_PERIOD) },  //ㄡ + ㄢ → 。
+  { COMBO2(13, 21), 1 << 2, MACRO(0) },                  //ㄛ + ㄜ → 謝謝
+};
+const uint8_t comboCount = sizeof(combos) / sizeof(combos[0]);
+
+//巨集：注音層常用詞（標準注音鍵位：ㄒ = V、ㄧ = U、ㄝ = ,、ˋ = 4）
+static const uint8_t macroXieXie[] PROGMEM = {
+  M_TAP(KEY_V), M_TAP(KEY_U), M_TAP(KEY_COMMA), M_TAP(KEY_4),
+  M_TAP(KEY_V), M_TAP(KEY_U), M_TAP(KEY_COMMA), M_TAP(KEY_4),
+  M_END
+};
+
+const uint8_t* const macros[] PROGMEM = {
+  macroXieXie,
+};
+const uint8_t macroCount = sizeof(macros) / sizeof(macros[0]);
@@ -0,0 +1,230 @@
+//可在執行時修改的鍵位表
+
+#include <avr/eeprom.h>
+#include <util/atomic.h>
+#include <util/crc16.h>
+#include "keymap_store.h"
+#include "eeprom_layout.h"
+#include "eeprom_writer.h"
+#include "layers.h"
+#include "progmem.h"
+
+#define KEYMAP_MAGIC 0x4B
+#define KEYMAP_FORMAT 2
+
+struct __attribute__((packed)) KeymapHeader {
+  uint8_t magic;
+  uint8_t format;  //格式變動（層數、鍵數、動作碼定義）時加 1，舊資料改用預設
+  uint16_t crc;
+};
+
+static_assert(sizeof(KeymapHeader) + sizeof(action_t) * LAYER_COUNT * KEY_COUNT <= EEPROM_KEYMAP_SIZE,
+              "keymap does not fit in EEPROM");
+
+#if OHK_KEYMAP_EDIT
+action_t keymap[LAYER_COUNT][KEY_COUNT];
+
+static KeymapHeader header;
+static bool saving;
+#endif
+
+static uint8_t source;
+static volatile uint16_t crc;  //整張表的 CRC（每次修改後重算，讀取時不必在中斷裡計算）
+
+//主機命令（USB 中斷寫入，主迴圈處理）
+static KeymapRequest pending;
+static volatile bool requestPending;
+static volatile uint8_t status;
+static volatile uint8_t readLayer, readStart, readCount;
+
+static void initRequests() {
+  requestPending = false;
+  status = KEYMAP_OK;
+  readLayer = 0;
+  readStart = 0;
+  readCount = 0;
+}
+
+#if OHK_KEYMAP_EDIT
+
+static uint16_t keymapCrc() {
+  uint16_t crc = 0xFFFF;
+  const uint8_t* p = (const uint8_t*)keymap;
+  for (uint16_t i = 0; i < sizeof(keymap); i++) {
+    crc = _crc16_update(crc, p[i]);
+  }
+  return crc;
+}
+
+static void loadDefault() {
+  memcpy_P(keymap, actionmaps, sizeof(keymap));
+  source = KEYMAP_SOURCE_DEFAULT;
+  crc = keymapCrc();
+}
+
+//從 EEPROM 載入，沒有有效資料時用預設
+static void loadSaved() {
+  KeymapHeader saved;
+  eeprom_read_block(&saved, (const void*)(uintptr_t)EEPROM_KEYMAP_ADDR, sizeof(saved));
+  if (saved.magic == KEYMAP_MAGIC && saved.format == KEYMAP_FORMAT) {
+    eeprom_read_block(keymap, (const void*)(uintptr_t)(EEPROM_KEYMAP_ADDR + sizeof(saved)), sizeof(keymap));
+    if (keymapCrc() == saved.crc) {
+      source = KEYMAP_SOURCE_EEPROM;
+      crc = saved.crc;
+      return;
+    }
+  }
+  loadDefault();
+}
+
+void keymapInit() {
+  loadSaved();
+  saving = false;
+  initRequests();
+}
+
+//整張表換掉時，按住中的鍵放開時會查到新的動作，先全部放開；
+//按住開啟的層也一併關閉，否則換掉的層鍵放開時不會再關閉它
+static void keymapChanged() {
+  actionReleaseAll();
+  layerClear();
+  layersRebuild();
+}
+
+static uint8_t handleRequest(const KeymapRequest& req) {
+  switch (req.cmd) {
+    case KEYMAP_CMD_WRITE:
+      if (req.layer >= LAYER_COUNT || req.count > KEYMAP_CHUNK || req.start + req.count > KEY_COUNT) {
+        return KEYMAP_BAD_ARGS;
+      }
+      memcpy(&keymap[req.layer][req.start], req.actions, req.count * sizeof(action_t));
+      source = KEYMAP_SOURCE_MODIFIED;
+      crc = keymapCrc();
+      keymapChanged();
+      return KEYMAP_OK;
+
+    case KEYMAP_CMD_COMMIT:
+      if (crc != req.crc) {
+        loadSaved();
+        keymapChanged();
+        return KEYMAP_CRC_MISMATCH;
+      }
+      header.magic = KEYMAP_MAGIC;
+      header.format = KEYMAP_FORMAT;
+      header.crc = req.crc;
+      if (!eepromWriterStart(EEPROM_KEYMAP_ADDR + sizeof(header), keymap, sizeof(keymap),
+                             EEPROM_KEYMAP_ADDR, &header, sizeof(header))) {
+        return KEYMAP_BUSY;
+      }
+      saving = true;
+      return KEYMAP_OK;
+
+    case KEYMAP_CMD_DEFAULT:
+      //只清掉標頭，下次開機就會用預設
+      header.magic = 0xFF;
+      header.format = 0xFF;
+      header.crc = 0xFFFF;
+      if (!eepromWriterStart(EEPROM_KEYMAP_ADDR, &header, sizeof(header), 0, NULL, 0)) {
+        return KEYMAP_BUSY;
+      }
+      loadDefault();
+      keymapChanged();
+      return KEYMAP_OK;
+
+    case KEYMAP_CMD_REVERT:
+      loadSaved();
+      keymapChanged();
+      return KEYMAP_OK;
+  }
+  return KEYMAP_BAD_ARGS;
+}
+
+void keymapUpdate() {
+  if (saving && !eepromWriterBusy()) {
+    saving = false;
+    source = KEYMAP_SOURCE_EEPROM;
+  }
+  if (!requestPending) {
+    return;
+  }
+  //存檔中不能改動 keymap（寫入的內容要與 CRC 一致）
+  const uint8_t result = saving ? (uint8_t)KEYMAP_BUSY : handleRequest(pending);
+  //ATOMIC_BLOCK 同時是記憶體屏障：keymap 與 crc 都寫完後，中斷才會看到 requestPending 清除
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    status = result;
+    requestPending = false;
+  }
+}
+
+static inline void readActions(void* dst, uint8_t layer, uint8_t start, uint8_t count) {
+  memcpy(dst, &keymap[layer][start], count * sizeof(action_t));
+}
+
+#else
+
+//唯讀：鍵位表只在 PROGMEM 中，不載入 EEPROM 的資料
+static uint16_t keymapCrc() {
+  uint16_t crc = 0xFFFF;
+  const uint8_t* p = (const uint8_t*)actionmaps;
+  for (uint16_t i = 0; i < sizeof(actionmaps); i++) {
+    crc = _crc16_update(crc, pgmRead(p + i));
+  }
+  return crc;
+}
+
+void keymapInit() {
+  source = KEYMAP_SOURCE_DEFAULT;
+  crc = keymapCrc();
+  initRequests();
+}
+
+void keymapUpdate() {
+  if (requestPending) {
+    status = KEYMAP_READ_ONLY;
+    requestPending = false;
+  }
+}
+
+static inline void readActions(void* dst, uint8_t layer, uint8_t start, uint8_t count) {
+  memcpy_P(dst, &actionmaps[layer][start], count * sizeof(action_t));
+}
+
+#endif
+
+bool keymapRequest(const KeymapRequest& request) {
+  if (requestPending) {
+    return false;
+  }
+  if (request.cmd == KEYMAP_CMD_READ) {
+    if (request.layer >= LAYER_COUNT || request.count > KEYMAP_CHUNK
+        || request.start + request.count > KEY_COUNT) {
+      status = KEYMAP_BAD_ARGS;
+      return true;
+    }
+    readLayer = request.layer;
+    readStart = request.start;
+    readCount = request.count;
+    status = KEYMAP_OK;
+    return true;
+  }
+  pending = request;
+  requestPending = true;
+  return true;
+}
+
+void keymapFillReport(KeymapReport& report) {
+  memset(&report, 0, sizeof(report));
+  report.version = KEYMAP_REPORT_VERSION;
+  report.source = source;
+  report.layer = readLayer;
+  report.start = readStart;
+  report.count = readCount;
+  //主迴圈處理命令期間 keymap 與 crc 可能只改了一半：只回報忙碌，不帶內容
+  if (requestPending) {
+    report.status = KEYMAP_BUSY;
+    return;
+  }
+  report.status = status;
+  report.crc = crc;
+  readActions(report.actions, readLayer, readStart, readCount);
+}
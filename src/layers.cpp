@@ -0,0 +1,144 @@
+//層堆疊
+
+#include "layers.h"
+#include "actions.h"
+#include "stats.h"
+#include "trace.h"
+#include "progmem.h"
+
+static layer_mask_t layerState;   //開啟的層
+static layer_mask_t toggled;      //其中由 TG 開啟的層
+static byte defaultLayer;
+static layer_mask_t opaque[KEY_COUNT];  //每個鍵在哪些層不是透明
+
+//單次層：ONESHOT_NONE 為沒有；按住期間有其他鍵按下則放開時關閉
+#define ONESHOT_NONE 0xFF
+static byte oneShotLayer;
+static bool oneShotHeld;
+static bool oneShotUsed;
+static bool oneShotOwned;  //層是單次層開啟的（原本沒開）；結束時才關閉，不動到 TG / MO 開的層
+
+//4 bits 內最高位元的位置
+static const uint8_t highestBit4[16] PROGMEM = { 0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3 };
+
+static byte highestBit(layer_mask_t m) {
+  if (m >> 8) {
+    return (m >> 12) ? 12 + pgmRead(&highestBit4[m >> 12]) : 8 + pgmRead(&highestBit4[(m >> 8) & 0x0F]);
+  }
+  return (m >> 4) ? 4 + pgmRead(&highestBit4[(m >> 4) & 0x0F]) : pgmRead(&highestBit4[m & 0x0F]);
+}
+
+static layer_mask_t activeMask() {
+  return layerState | ((layer_mask_t)1 << defaultLayer);
+}
+
+//最上層改變時更新 currentLayer（狀態回報用）
+static void updateCurrent() {
+  const byte top = highestBit(activeMask());
+  if (top != currentLayer) {
+    currentLayer = top;
+    telemetryDirty = true;
+    TRACE(TRACE_LAYER, 0, currentLayer, 0);
+  }
+}
+
+void layersInit() {
+  layerState = 0;
+  toggled = 0;
+  defaultLayer = 0;
+  oneShotLayer = ONESHOT_NONE;
+  currentLayer = 0;
+  layersRebuild();
+}
+
+void layersRebuild() {
+  for (byte k = 0; k < KEY_COUNT; k++) {
+    layer_mask_t m = 0;
+    for (byte l = 0; l < LAYER_COUNT; l++) {
+      if (ACTION_TYPE(actionAt(l, k)) != ACT_TRANSPARENT) {
+        m |= (layer_mask_t)1 << l;
+      }
+    }
+    opaque[k] = m;
+  }
+}
+
+byte layersResolve(byte keyID) {
+  const layer_mask_t m = activeMask() & opaque[keyID];
+  //所有作用中的層都是透明：查預設層（結果仍是透明，不做任何事）
+  return m ? highestBit(m) : defaultLayer;
+}
+
+void layerOn(byte layer) {
+  layerState |= (layer_mask_t)1 << layer;
+  updateCurrent();
+}
+
+void layerOff(byte layer) {
+  layerState &= ~((layer_mask_t)1 << layer);
+  toggled &= layerState;
+  updateCurrent();
+}
+
+void layerToggle(byte layer) {
+  layerState ^= (layer_mask_t)1 << layer;
+  toggled = (toggled ^ ((layer_mask_t)1 << layer)) & layerState;
+  updateCurrent();
+}
+
+void layerClear() {
+  layerState = toggled;
+  oneShotLayer = ONESHOT_NONE;
+  updateCurrent();
+}
+
+void layerSetDefault(byte layer) {
+  defaultLayer = layer;
+  updateCurrent();
+}
+
+//結束單次層：只關閉單次層自己開啟的層
+static void oneShotEnd() {
+  if (oneShotLayer == ONESHOT_NONE) {
+    return;
+  }
+  const byte layer = oneShotLayer;
+  oneShotLayer = ONESHOT_NONE;
+  if (oneShotOwned) {
+    layerOff(layer);
+  }
+}
+
+void layerOneShot(byte layer) {
+  if (oneShotLayer != layer) {
+    //前一個單次層還沒用掉：先結束，否則它會一直開著
+    oneShotEnd();
+    oneShotOwned = !(layerState & ((layer_mask_t)1 << layer));
+  }
+  oneShotLayer = layer;
+  oneShotHeld = true;
+  oneShotUsed = false;
+  layerOn(layer);
+}
+
+void layerOneShotRelease(byte layer) {
+  if (oneShotLayer != layer) {
+    return;
+  }
+  oneShotHeld = false;
+  //按住期間已經用過（當成 MOMENTARY）：放開就關閉
+  if (oneShotUsed) {
+    oneShotEnd();
+  }
+}
+
+void layerOneShotConsume() {
+  if (oneShotLayer == ONESHOT_NONE) {
+    return;
+  }
+  if (oneShotHeld) {
+    oneShotUsed = true;
+    return;
+  }
+  oneShotEnd();
+}
@@ -0,0 +1,83 @@
+//巨集排程：一次執行到產生一份回報變化為止，等 reportFlush() 送出後再繼續
+
+#include "macros.h"
+#include "progmem.h"
+#include "actions.h"
+#include "layers.h"
+#include "report.h"
+#include "config.h"
+
+#define MACRO_QUEUE 4  //播放中再按下的巨集最多排隊幾個
+
+static uint8_t queue[MACRO_QUEUE];
+static uint8_t queueHead = 0;
+static uint8_t queueLen = 0;
+
+static const uint8_t* pc = nullptr;  //目前播放位置（PROGMEM），nullptr 表示沒有在播放
+static uint16_t waitStart;
+static uint8_t waitMs = 0;
+
+void macroPlay(uint8_t index) {
+  if (index >= macroCount || queueLen == MACRO_QUEUE) {
+    return;
+  }
+  queue[(queueHead + queueLen) % MACRO_QUEUE] = index;
+  queueLen++;
+}
+
+void macroUpdate(uint32_t nowMs) {
+  //上一步的變化還沒送出（同一個 frame、或點按延到下一份回報的放開）
+  if (reportPending()) {
+    return;
+  }
+  if (waitMs) {
+    if ((uint16_t)((uint16_t)nowMs - waitStart) < waitMs) {
+      return;
+    }
+    waitMs = 0;
+  }
+  if (!pc) {
+    if (!queueLen) {
+      return;
+    }
+    pc = pgmRead(&macros[queue[queueHead]]);
+    queueHead = (queueHead + 1) % MACRO_QUEUE;
+    queueLen--;
+  }
+
+  for (;;) {
+    const uint8_t op = pgmRead(pc++);
+    if (op == MACRO_END) {
+      pc = nullptr;
+      return;
+    }
+    const uint8_t arg = pgmRead(pc++);
+    switch (op) {
+      case MACRO_DOWN:
+        actionKey(arg, true);
+        return;
+      case MACRO_UP:
+        actionKey(arg, false);
+        return;
+      case MACRO_TAP:
+        //同一個 frame 內按下的鍵，report 會把放開延到下一份回報
+        actionKey(arg, true);
+        actionKey(arg, false);
+        return;
+      case MACRO_WAIT:
+        waitStart = (uint16_t)nowMs;
+        waitMs = arg;
+        return;
+      case MACRO_LAYER_ON:
+        if (arg < LAYER_COUNT) layerOn(arg);
+        break;
+      case MACRO_LAYER_OFF:
+        if (arg < LAYER_COUNT) layerOff(arg);
+        break;
+    }
+  }
+}
+
+bool macroBusy() {
+  return pc || queueLen;
+}
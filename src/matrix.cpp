@@ -0,0 +1,154 @@
+//矩陣掃描：直接操作 AVR 埠暫存器
+//與原本的 Keypad 相同，輪流把一列（COL）拉低，再從各行（ROW）讀回按下狀態，
+//因此二極體方向不需更動。每列只讀三個 PIN 暫存器，掃描全矩陣約 160 個 cycle。
+
+#include "matrix.h"
+#include "progmem.h"
+
+//矩陣行列腳位定義（初始化用；掃描時直接操作下列對應的埠位元）
+//  行 ROWS：9=PB5  8=PB4  7=PE6  6=PD7  14=PB3  16=PB2  10=PB6
+//  列 COLS：A0=PF7 A1=PF6 A2=PF5 A3=PF4 2=PD1  3=PD0  4=PD4  5=PC6
+static const byte rowPins[ROWS] PROGMEM = { 9, 8, 7, 6, 14, 16, 10 };
+static const byte colPins[COLS] PROGMEM = { A0, A1, A2, A3, 2, 3, 4, 5 };
+
+//一次讀回所有行：PB2..PB6 在 bit2..6，PD7 放到 bit7，PE6 放到 bit0（bit1 未使用）
+#define ROW_BITS_MASK 0xFD
+
+static inline uint8_t readRows() {
+  uint8_t v = PINB & 0x7C;
+  if (PIND & _BV(7)) v |= _BV(7);
+  if (PINE & _BV(6)) v |= _BV(0);
+  return v;
+}
+
+//旋鈕按鍵 SW_PIN（15）= PB1，接地觸發
+#define SW_PRESSED() (!(PINB & _BV(1)))
+
+//readRows() 的位元 -> 行號
+static const uint8_t rowOfBit[8] PROGMEM = { 2, 0xFF, 5, 4, 1, 0, 6, 3 };
+
+//選取列：先關上拉再切成輸出低電位
+//釋放列：先主動推高（把行線快速拉回高電位，避免影響下一列），再切回輸入上拉
+#define SCAN_COL(i, ddr, port, b)         \
+  do {                                     \
+    port &= ~_BV(b);                       \
+    ddr |= _BV(b);                         \
+    asm volatile ("nop\n\tnop\n\t");       \
+    raw[i] = readRows();                   \
+    port |= _BV(b);                        \
+    ddr &= ~_BV(b);                        \
+  } while (0)
+
+static uint8_t rawPrev[COLS];
+static bool swPrev;
+static matrix_t state;
+
+void matrixInit() {
+  for (byte r = 0; r < ROWS; r++) {
+    pinMode(pgmRead(&rowPins[r]), INPUT_PULLUP);
+  }
+  for (byte c = 0; c < COLS; c++) {
+    pinMode(pgmRead(&colPins[c]), INPUT_PULLUP);
+    rawPrev[c] = ROW_BITS_MASK;
+  }
+  pinMode(SW_PIN, INPUT_PULLUP);
+  swPrev = false;
+  state.word = 0;
+}
+
+const matrix_t& matrixScan() {
+  uint8_t raw[COLS];
+  SCAN_COL(0, DDRF, PORTF, 7);
+  SCAN_COL(1, DDRF, PORTF, 6);
+  SCAN_COL(2, DDRF, PORTF, 5);
+  SCAN_COL(3, DDRF, PORTF, 4);
+  SCAN_COL(4, DDRD, PORTD, 1);
+  SCAN_COL(5, DDRD, PORTD, 0);
+  SCAN_COL(6, DDRD, PORTD, 4);
+  SCAN_COL(7, DDRC, PORTC, 6);
+  const bool sw = SW_PRESSED();
+
+  //沒有任何變化時直接沿用上次的結果
+  bool changed = (sw != swPrev);
+  swPrev = sw;
+  for (byte c = 0; c < COLS; c++) {
+    if (raw[c] != rawPrev[c]) {
+      rawPrev[c] = raw[c];
+      changed = true;
+    }
+  }
+  if (!changed) {
+    return state;
+  }
+
+  //重新排成 keyID 順序（按下為低電位）
+  matrix_t next;
+  next.word = 0;
+  for (byte c = 0; c < COLS; c++) {
+    uint8_t pressed = ~raw[c] & ROW_BITS_MASK;
+    for (uint8_t b = 0; pressed; b++, pressed >>= 1) {
+      if (pressed & 1) {
+        next.rows[pgmRead(&rowOfBit[b])] |= (uint8_t)(1 << c);
+      }
+    }
+  }
+  if (sw) {
+    next.rows[ENC_SW_KEY_ID / 8] |= (uint8_t)(1 << (ENC_SW_KEY_ID % 8));
+  }
+  state = next;
+  return state;
+}
+
+//列腳位：PF7..PF4、PD1 / PD0 / PD4、PC6
+#define COLS_F (_BV(7) | _BV(6) | _BV(5) | _BV(4))
+#define COLS_D (_BV(1) | _BV(0) | _BV(4))
+#define COLS_C _BV(6)
+
+//喚醒用的 pin change：行 PB2..PB6 與旋鈕按鍵 PB1
+#define WAKE_PCMSK 0x7E
+
+//喚醒中斷只負責叫醒 MCU；INT6 低電位觸發在按住時會一直進中斷，觸發一次就先關掉
+EMPTY_INTERRUPT(PCINT0_vect);
+
+ISR(INT6_vect) {
+  EIMSK &= ~_BV(INT6);
+}
+
+void matrixIdleArm() {
+  PORTF &= ~COLS_F;
+  DDRF |= COLS_F;
+  PORTD &= ~COLS_D;
+  DDRD |= COLS_D;
+  PORTC &= ~COLS_C;
+  DDRC |= COLS_C;
+
+  PCMSK0 = WAKE_PCMSK;
+  PCIFR = _BV(PCIF0);
+  PCICR |= _BV(PCIE0);
+  //INT6 只有低電位觸發能在 power-down 中喚醒
+  EICRB &= ~(_BV(ISC61) | _BV(ISC60));
+  EIFR = _BV(INTF6);
+  EIMSK |= _BV(INT6);
+}
+
+void matrixIdleRearm() {
+  EIFR = _BV(INTF6);
+  EIMSK |= _BV(INT6);
+}
+
+void matrixIdleDisarm() {
+  PCICR &= ~_BV(PCIE0);
+  EIMSK &= ~_BV(INT6);
+
+  //與 SCAN_COL 的釋放相同：先推高再切回輸入上拉
+  PORTF |= COLS_F;
+  DDRF &= ~COLS_F;
+  PORTD |= COLS_D;
+  DDRD &= ~COLS_D;
+  PORTC |= COLS_C;
+  DDRC &= ~COLS_C;
+}
+
+bool matrixIdlePressed() {
+  return readRows() != ROW_BITS_MASK || SW_PRESSED();
+}
@@ -0,0 +1,35 @@
+//鬼鍵過濾：只做位元運算，不接觸硬體（原生模擬也使用同一份）
+
+#include "matrix.h"
+
+const matrix_t& matrixGhostFilter(const matrix_t& state, const matrix_t& prev) {
+#if OHK_GHOST_FILTER
+  static matrix_t filtered;
+
+  //先找出被兩行以上共用的列：少於兩列就不可能形成矩形（多數掃描在這裡就結束）
+  uint8_t seen = 0;
+  uint8_t shared = 0;
+  for (byte r = 0; r < ROWS; r++) {
+    shared |= seen & state.rows[r];
+    seen |= state.rows[r];
+  }
+  if (!(shared & (shared - 1))) {
+    return state;
+  }
+
+  filtered = state;
+  for (byte i = 0; i < ROWS - 1; i++) {
+    for (byte j = i + 1; j < ROWS; j++) {
+      const uint8_t cols = state.rows[i] & state.rows[j];
+      if (cols & (cols - 1)) {
+        filtered.rows[i] &= prev.rows[i] | ~cols;
+        filtered.rows[j] &= prev.rows[j] | ~cols;
+      }
+    }
+  }
+  return filtered;
+#else
+  (void)prev;
+  return state;
+#endif
+}
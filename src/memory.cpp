@@ -0,0 +1,64 @@
+//RAM 使用量監測
+
+#include "memory.h"
+#include "stats.h"
+
+//連結器與 avr-libc 提供的位址
+extern uint8_t __data_start;
+extern uint8_t __heap_start;
+extern void* __brkval;  //malloc 目前的 heap 頂端（沒用過 malloc 時為 0）
+
+//.init1 在設定 r1 與堆疊指標、複製 .data 之前執行，只能用組合語言且不能有函式框架；
+//此時堆疊還沒有任何內容，可以一路填到 RAMEND
+void memoryPaint() __attribute__((naked, used, section(".init1")));
+void memoryPaint() {
+  asm volatile(
+    "  ldi r30, lo8(__heap_start)\n"
+    "  ldi r31, hi8(__heap_start)\n"
+    "  ldi r24, %[canary]\n"
+    "  ldi r25, hi8(%[end])\n"
+    "1:\n"
+    "  st Z+, r24\n"
+    "  cpi r30, lo8(%[end])\n"
+    "  cpc r31, r25\n"
+    "  brlo 1b\n"
+    :
+    : [canary] "M"(MEMORY_CANARY), [end] "i"(RAMEND + 1));
+}
+
+static uint8_t* lowWater;  //堆疊寫到過的最低位址
+static uint8_t* cursor;    //下一段從這裡開始檢查
+
+static inline uint8_t* heapEnd() {
+  return __brkval ? (uint8_t*)__brkval : &__heap_start;
+}
+
+void memoryInit() {
+  lowWater = (uint8_t*)(uintptr_t)SP;
+  cursor = heapEnd();
+}
+
+void memoryUpdate() {
+  uint8_t* p = cursor;
+  uint8_t* end = p + MEMORY_SCAN_CHUNK;
+  if (end > lowWater) {
+    end = lowWater;
+  }
+  for (; p < end; p++) {
+    if (*p != MEMORY_CANARY) {
+      lowWater = p;
+      telemetryDirty = true;
+      break;
+    }
+  }
+  //到達目前的最低位址（或找到更低的）就從 heap 頂端重新開始
+  cursor = (p < lowWater) ? p : heapEnd();
+}
+
+void memoryGetStats(MemoryStats& stats) {
+  uint8_t* heap = heapEnd();
+  stats.staticBytes = (uint16_t)(&__heap_start - &__data_start);
+  stats.heapBytes = (uint16_t)(heap - &__heap_start);
+  stats.stackPeak = (uint16_t)((uint8_t*)(RAMEND + 1) - lowWater);
+  stats.freeMin = lowWater > heap ? (uint16_t)(lowWater - heap) : 0;
+}
@@ -0,0 +1,27 @@
+//原生模擬用的 Arduino 介面：只提供韌體邏輯用到的部分，時間與 USB frame 由 sim_hal.cpp 的模擬時鐘提供
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+typedef uint8_t byte;
+
+#define F_CPU 16000000UL
+
+#define _BV(b) (1 << (b))
+#define constrain(a, low, high) ((a) < (low) ? (low) : ((a) > (high) ? (high) : (a)))
+
+unsigned long millis();
+
+//USB frame 編號低 8 位（report.cpp 以此對齊主機輪詢）
+extern volatile uint8_t UDFNUML;
+
+//USB 裝置狀態：模擬中主機一直連線，不會暫停
+class USBDevice_ {
+public:
+  bool isSuspended() { return false; }
+};
+extern USBDevice_ USBDevice;
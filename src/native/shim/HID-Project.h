@@ -0,0 +1,60 @@
+//原生模擬：HID-Project 的鍵碼與鍵盤介面
+//鍵盤回報只記錄目前按下的鍵碼，send() 交給 sim_hal.cpp 統計回報數與延遲。
+#pragma once
+
+#include <Arduino.h>
+#include <HID.h>
+
+//HID Usage Table（Keyboard/Keypad Page）
+enum KeyboardKeycode : uint8_t {
+  KEY_RESERVED = 0,
+  KEY_A = 4, KEY_B, KEY_C, KEY_D, KEY_E, KEY_F, KEY_G, KEY_H, KEY_I, KEY_J, KEY_K, KEY_L, KEY_M,
+  KEY_N, KEY_O, KEY_P, KEY_Q, KEY_R, KEY_S, KEY_T, KEY_U, KEY_V, KEY_W, KEY_X, KEY_Y, KEY_Z,
+  KEY_1, KEY_2, KEY_3, KEY_4, KEY_5, KEY_6, KEY_7, KEY_8, KEY_9, KEY_0,
+  KEY_ENTER, KEY_ESC, KEY_BACKSPACE, KEY_TAB, KEY_SPACE, KEY_MINUS, KEY_EQUAL,
+  KEY_LEFT_BRACE, KEY_RIGHT_BRACE, KEY_BACKSLASH, KEY_NON_US_NUM, KEY_SEMICOLON, KEY_QUOTE,
+  KEY_TILDE, KEY_COMMA, KEY_PERIOD, KEY_SLASH, KEY_CAPS_LOCK,
+  KEY_F1, KEY_F2, KEY_F3, KEY_F4, KEY_F5, KEY_F6, KEY_F7, KEY_F8, KEY_F9, KEY_F10, KEY_F11, KEY_F12,
+  KEY_PRINT, KEY_SCROLL_LOCK, KEY_PAUSE, KEY_INSERT, KEY_HOME, KEY_PAGE_UP, KEY_DELETE, KEY_END,
+  KEY_PAGE_DOWN, KEY_RIGHT, KEY_LEFT, KEY_DOWN, KEY_UP,
+  KEY_LEFT_CTRL = 0xE0, KEY_LEFT_SHIFT, KEY_LEFT_ALT, KEY_LEFT_GUI,
+  KEY_RIGHT_CTRL, KEY_RIGHT_SHIFT, KEY_RIGHT_ALT, KEY_RIGHT_GUI,
+  KEY_LEFT_WINDOWS = KEY_LEFT_GUI,
+};
+
+#define MOUSE_LEFT   (1 << 0)
+#define MOUSE_RIGHT  (1 << 1)
+#define MOUSE_MIDDLE (1 << 2)
+
+class KeyboardAPI {
+public:
+  void begin() {}
+  size_t add(KeyboardKeycode k) {
+    keys[k >> 3] |= (uint8_t)(1 << (k & 7));
+    return 1;
+  }
+  size_t remove(KeyboardKeycode k) {
+    keys[k >> 3] &= (uint8_t)~(1 << (k & 7));
+    return 1;
+  }
+  size_t removeAll() {
+    memset(keys, 0, sizeof(keys));
+    return 1;
+  }
+  bool isPressed(uint8_t k) const {
+    return (keys[k >> 3] >> (k & 7)) & 1;
+  }
+  int send();  //sim_hal.cpp
+  uint8_t getProtocol() {
+    return HID_REPORT_PROTOCOL;
+  }
+
+private:
+  uint8_t keys[32] = {};
+  uint8_t sent[32] = {};  //上次送出的內容
+};
+
+typedef KeyboardAPI BootKeyboard_;
+typedef KeyboardAPI NKROKeyboard_;
+extern BootKeyboard_ BootKeyboard;
+extern NKROKeyboard_ NKROKeyboard;
@@ -0,0 +1,7 @@
+//原生模擬：HID 常數
+#pragma once
+
+#include <PluggableUSB.h>
+
+#define HID_BOOT_PROTOCOL 0
+#define HID_REPORT_PROTOCOL 1
@@ -0,0 +1,22 @@
+//原生模擬：只保留 usb_hid.h 宣告需要的型別
+#pragma once
+
+#include <Arduino.h>
+
+struct USBSetup {
+  uint8_t bmRequestType;
+  uint8_t bRequest;
+  uint8_t wValueL;
+  uint8_t wValueH;
+  uint16_t wIndex;
+  uint16_t wLength;
+};
+
+class PluggableUSBModule {
+public:
+  PluggableUSBModule(uint8_t numEps, uint8_t numIfs, uint8_t* epType) {
+    (void)numEps;
+    (void)numIfs;
+    (void)epType;
+  }
+};
@@ -0,0 +1,11 @@
+//原生模擬：EEPROM 以記憶體陣列代替（定義於 sim_hal.cpp，初始為 0xFF，寫入立即完成）
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+uint8_t eeprom_read_byte(const uint8_t* addr);
+void eeprom_write_byte(uint8_t* addr, uint8_t value);
+void eeprom_read_block(void* dst, const void* src, size_t n);
+
+#define eeprom_is_ready() 1
@@ -0,0 +1,5 @@
+//原生模擬：沒有中斷，ATOMIC_BLOCK 只是一般區塊
+#pragma once
+
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_BLOCK(type) for (int atomicOnce_ = 1; atomicOnce_; atomicOnce_ = 0)
@@ -0,0 +1,29 @@
+//原生模擬的硬體狀態
+//matrix / encoder / perf 時鐘 / USB 回報在這裡以模擬版本實作（sim_hal.cpp），
+//其餘韌體邏輯與 AVR 版本共用同一份原始碼。
+#pragma once
+
+#include <Arduino.h>
+#include "matrix.h"
+
+//目前按下的鍵（matrixScan() 直接回傳，沒有彈跳）
+extern matrix_t simMatrix;
+
+//尚未被 encoderTakeDelta() 取出的旋鈕段數
+extern int8_t simEncoder;
+
+//模擬時鐘（cycle，F_CPU 為 16MHz）；前進時一併更新 millis() 與 USB frame 編號
+uint64_t simCycles();
+void simAdvance(uint32_t cycles);
+
+//已送出的回報數
+struct SimReportStats {
+  uint32_t keyboard;
+  uint32_t mouse;
+  uint32_t vendor;
+};
+extern SimReportStats simReports;
+
+//每送出一份鍵盤或滑鼠回報時呼叫（定義於 sim_main.cpp，用來量測延遲）
+//pressed：這份回報中有新按下的鍵碼或滑鼠按鍵
+void simOnReport(bool pressed);
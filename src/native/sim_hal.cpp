@@ -0,0 +1,131 @@
+//原生模擬的硬體層：取代 matrix.cpp、encoder.cpp、perf_timer.cpp、usb_hid.cpp、memory.cpp、power.cpp 與 HID-Project
+
+#include <HID-Project.h>
+#include <avr/eeprom.h>
+#include "sim.h"
+#include "encoder.h"
+#include "perf.h"
+#include "usb_hid.h"
+#include "memory.h"
+#include "power.h"
+#include "eeprom_layout.h"
+
+matrix_t simMatrix;
+int8_t simEncoder;
+SimReportStats simReports;
+volatile uint8_t UDFNUML;
+USBDevice_ USBDevice;
+
+static uint64_t cycles;
+
+uint64_t simCycles() {
+  return cycles;
+}
+
+void simAdvance(uint32_t n) {
+  cycles += n;
+  UDFNUML = (uint8_t)millis();
+}
+
+unsigned long millis() {
+  return (unsigned long)(cycles / (F_CPU / 1000));
+}
+
+void perfTimerInit() {}
+
+uint32_t perfNow() {
+  return (uint32_t)cycles;
+}
+
+//RAM 用量只在 AVR 上有意義
+void memoryInit() {}
+
+void memoryUpdate() {}
+
+void memoryGetStats(MemoryStats& stats) {
+  memset(&stats, 0, sizeof(stats));
+}
+
+//模擬程式直接呼叫 keyboardScan()，不進入閒置
+void powerGetStats(PowerStats& stats) {
+  memset(&stats, 0, sizeof(stats));
+}
+
+void matrixInit() {
+  simMatrix.word = 0;
+}
+
+const matrix_t& matrixScan() {
+  return simMatrix;
+}
+
+void encoderInit() {
+  simEncoder = 0;
+}
+
+int8_t encoderTakeDelta() {
+  const int8_t delta = simEncoder;
+  simEncoder = 0;
+  return delta;
+}
+
+//EEPROM：初始為抹除狀態（0xFF）
+static uint8_t eeprom[EEPROM_SIZE];
+static bool eepromErased = false;
+
+static uint8_t* eepromAt(const void* addr) {
+  if (!eepromErased) {
+    memset(eeprom, 0xFF, sizeof(eeprom));
+    eepromErased = true;
+  }
+  return &eeprom[(uintptr_t)addr % sizeof(eeprom)];
+}
+
+uint8_t eeprom_read_byte(const uint8_t* addr) {
+  return *eepromAt(addr);
+}
+
+void eeprom_write_byte(uint8_t* addr, uint8_t value) {
+  *eepromAt(addr) = value;
+}
+
+void eeprom_read_block(void* dst, const void* src, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    ((uint8_t*)dst)[i] = *eepromAt((const uint8_t*)src + i);
+  }
+}
+
+//USB 回報
+BootKeyboard_ BootKeyboard;
+NKROKeyboard_ NKROKeyboard;
+
+int KeyboardAPI::send() {
+  bool pressed = false;
+  for (uint8_t i = 0; i < sizeof(keys); i++) {
+    pressed |= (keys[i] & ~sent[i]) != 0;
+  }
+  memcpy(sent, keys, sizeof(sent));
+  simReports.keyboard++;
+  simOnReport(pressed);
+  return 1;
+}
+
+UsbHid_::UsbHid_() : PluggableUSBModule(1, 1, epType), protocol(HID_REPORT_PROTOCOL), idle(1), resolution(0) {
+  epType[0] = 0;
+}
+
+int UsbHid_::sendReport(uint8_t id, const void* data, int len) {
+  if (id == USB_HID_REPORTID_MOUSE) {
+    static uint8_t lastButtons = 0;
+    const uint8_t buttons = ((const UsbHidMouseReport*)data)->buttons;
+    simReports.mouse++;
+    simOnReport((buttons & ~lastButtons) != 0);
+    lastButtons = buttons;
+  }
+  else {
+    simReports.vendor++;
+  }
+  return len;
+}
+
+UsbHid_ UsbHid;
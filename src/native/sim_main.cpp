@@ -0,0 +1,193 @@
+//原生模擬：把錄下的或合成的按鍵事件依時間寫進模擬矩陣，以 SCAN_RATE_HZ 的節拍執行
+//keyboardScan()，統計處理速度、每次按鍵的回報數與按下到回報的模擬延遲。
+//
+//  program [events.csv] [--keys N] [--seed S] [--max-latency-ms X] [--max-reports-per-key Y]
+//
+//events.csv 為監控 App 記錄的事件串流（time_ms,key_id,pressed,layer）；沒有指定時
+//產生 N 次（預設 2000）隨機打字。指定上限時超過即以 1 結束，可在 CI 做回歸檢查。
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "sim.h"
+#include "config.h"
+#include "keyboard.h"
+#include "report.h"
+#include "encoder.h"
+#include "perf.h"
+
+#define CYCLES_PER_US (F_CPU / 1000000)
+
+struct SimEvent {
+  uint64_t timeUs;
+  uint8_t keyID;
+  bool pressed;
+};
+
+//延遲量測：最近一次實體按下的時間，之後第一份含新按下內容的回報即為它的延遲
+//（層鍵等不產生回報的按下會被下一次按下取代）
+static bool pressPending = false;
+static uint64_t pressCycles;
+static uint32_t latencySamples = 0;
+static uint64_t latencySum = 0;
+static uint64_t latencyMax = 0;
+
+void simOnReport(bool pressed) {
+  if (!pressed || !pressPending) {
+    return;
+  }
+  pressPending = false;
+  const uint64_t latency = simCycles() - pressCycles;
+  latencySamples++;
+  latencySum += latency;
+  latencyMax = std::max(latencyMax, latency);
+}
+
+//監控 App 的事件記錄（第一行為標題）
+static bool loadCsv(const char* path, std::vector<SimEvent>& events) {
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "無法開啟 %s\n", path);
+    return false;
+  }
+  char line[128];
+  bool header = true;
+  while (fgets(line, sizeof(line), f)) {
+    if (header) {
+      header = false;
+      continue;
+    }
+    unsigned long timeMs;
+    unsigned keyID;
+    unsigned pressed;
+    if (sscanf(line, "%lu,%u,%u", &timeMs, &keyID, &pressed) == 3 && keyID < INPUT_COUNT) {
+      events.push_back({ (uint64_t)timeMs * 1000, (uint8_t)keyID, pressed != 0 });
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+//隨機打字：英文層字母與空白鍵，偶爾按住 SHIFT（點按 / 按住鍵）再打字，
+//約兩成的按鍵在前一鍵放開前就按下（滾動打字）
+static uint32_t rng;
+
+static uint32_t randomRange(uint32_t low, uint32_t high) {
+  rng = rng * 1103515245u + 12345u;
+  return low + (rng >> 8) % (high - low + 1);
+}
+
+static void synthesize(uint32_t keys, std::vector<SimEvent>& events) {
+  static const uint8_t letters[] = { 25, 26, 27, 28, 29, 30, 33, 34, 35, 36, 37, 38, 41, 42, 43, 44, 50 };
+  const uint8_t SHIFT = 32;
+  uint64_t t = 100000;
+  for (uint32_t i = 0; i < keys; i++) {
+    const uint8_t key = letters[randomRange(0, sizeof(letters) - 1)];
+    const uint64_t dwell = randomRange(50000, 110000);
+    if (randomRange(0, 9) == 0) {
+      const uint64_t lead = randomRange(40000, 80000);
+      events.push_back({ t, SHIFT, true });
+      events.push_back({ t + lead, key, true });
+      events.push_back({ t + lead + dwell, key, false });
+      events.push_back({ t + lead + dwell + randomRange(10000, 40000), SHIFT, false });
+      t += lead + dwell + randomRange(80000, 160000);
+      continue;
+    }
+    events.push_back({ t, key, true });
+    events.push_back({ t + dwell, key, false });
+    const bool roll = randomRange(0, 4) == 0;
+    t += roll ? dwell - randomRange(10000, 40000) : dwell + randomRange(30000, 150000);
+  }
+}
+
+int main(int argc, char** argv) {
+  const char* path = nullptr;
+  uint32_t keys = 2000;
+  double maxLatencyMs = 0;
+  double maxReportsPerKey = 0;
+  rng = 1;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--keys") && i + 1 < argc) keys = (uint32_t)atol(argv[++i]);
+    else if (!strcmp(argv[i], "--seed") && i + 1 < argc) rng = (uint32_t)atol(argv[++i]);
+    else if (!strcmp(argv[i], "--max-latency-ms") && i + 1 < argc) maxLatencyMs = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--max-reports-per-key") && i + 1 < argc) maxReportsPerKey = atof(argv[++i]);
+    else path = argv[i];
+  }
+
+  std::vector<SimEvent> events;
+  if (path) {
+    if (!loadCsv(path, events)) {
+      return 2;
+    }
+  }
+  else {
+    synthesize(keys, events);
+  }
+  std::stable_sort(events.begin(), events.end(),
+                   [](const SimEvent& a, const SimEvent& b) { return a.timeUs < b.timeUs; });
+  if (events.empty()) {
+    fprintf(stderr, "沒有事件\n");
+    return 2;
+  }
+
+  perfInit();
+  reportBegin();
+  matrixInit();
+  encoderInit();
+  keyboardInit();
+
+  //從第一個事件前 100ms 開始，最後一個事件後再跑 1 秒讓判定與延後的放開都送出
+  const uint32_t tickCycles = F_CPU / SCAN_RATE_HZ;
+  const uint64_t startUs = events.front().timeUs > 100000 ? events.front().timeUs - 100000 : 0;
+  const uint64_t endUs = events.back().timeUs - startUs + 1000000;
+  uint32_t presses = 0;
+  uint32_t ticks = 0;
+  size_t next = 0;
+
+  const auto wallStart = std::chrono::steady_clock::now();
+  while (simCycles() / CYCLES_PER_US < endUs) {
+    const uint64_t nowUs = simCycles() / CYCLES_PER_US;
+    for (; next < events.size() && events[next].timeUs - startUs <= nowUs; next++) {
+      const SimEvent& e = events[next];
+      if (e.pressed) {
+        simMatrix.word |= (uint64_t)1 << e.keyID;
+        presses++;
+        pressPending = true;
+        pressCycles = (e.timeUs - startUs) * CYCLES_PER_US;
+      }
+      else {
+        simMatrix.word &= ~((uint64_t)1 << e.keyID);
+      }
+    }
+    keyboardScan();
+    simAdvance(tickCycles);
+    ticks++;
+  }
+  const double wallSec =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+  const double simSec = (double)simCycles() / F_CPU;
+  const uint32_t reports = simReports.keyboard + simReports.mouse;
+  const double reportsPerKey = presses ? (double)reports / presses : 0;
+  const double cyclesPerMs = F_CPU / 1000.0;
+  const double avgLatencyMs = latencySamples ? latencySum / cyclesPerMs / latencySamples : 0;
+  const double maxLatency = latencyMax / cyclesPerMs;
+
+  printf("事件：%zu（按下 %u 次），模擬時間 %.1f 秒，節拍 %u Hz\n", events.size(), presses, simSec, SCAN_RATE_HZ);
+  printf("處理速度：%.0f 事件/秒，平均每節拍 %.0f ns（實際耗時 %.3f 秒）\n",
+         wallSec > 0 ? events.size() / wallSec : 0, wallSec * 1e9 / ticks, wallSec);
+  printf("回報：鍵盤 %u、滑鼠 %u，每次按下 %.2f 份\n", simReports.keyboard, simReports.mouse, reportsPerKey);
+  printf("按下到回報延遲：平均 %.3f ms、最大 %.3f ms（%u 筆）\n", avgLatencyMs, maxLatency, latencySamples);
+
+  int result = 0;
+  if (maxLatencyMs > 0 && maxLatency > maxLatencyMs) {
+    printf("超過上限：最大延遲 %.3f ms > %.3f ms\n", maxLatency, maxLatencyMs);
+    result = 1;
+  }
+  if (maxReportsPerKey > 0 && reportsPerKey > maxReportsPerKey) {
+    printf("超過上限：每次按下 %.2f 份回報 > %.2f\n", reportsPerKey, maxReportsPerKey);
+    result = 1;
+  }
+  return result;
+}
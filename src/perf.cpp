@@ -0,0 +1,103 @@
+//效能量測
+//時間戳由 perf_timer.cpp（Timer1）提供，原生模擬改用模擬時鐘。
+//直方圖只在主迴圈更新；USB 中斷的重置命令只設旗標，由下一次 perfRecord() 清除，
+//避免和主迴圈同時寫入。
+
+#include "perf.h"
+
+struct Histogram {
+  uint32_t count;
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint16_t buckets[PERF_BUCKETS];
+};
+
+static Histogram histograms[PERF_HISTOGRAM_COUNT];
+static volatile uint8_t resetMask;
+static volatile uint8_t selected;
+static uint32_t eventStart;
+static bool eventPending;
+
+static void clearHistogram(Histogram& h) {
+  memset(&h, 0, sizeof(h));
+  h.minCycles = 0xFFFFFFFF;
+}
+
+static uint8_t bucketOf(uint32_t cycles) {
+  uint8_t b = 0;
+  cycles >>= PERF_BUCKET_SHIFT + 1;
+  while (cycles && b < PERF_BUCKETS - 1) {
+    cycles >>= 1;
+    b++;
+  }
+  return b;
+}
+
+void perfInit() {
+  for (uint8_t i = 0; i < PERF_HISTOGRAM_COUNT; i++) {
+    clearHistogram(histograms[i]);
+  }
+  resetMask = 0;
+  selected = PERF_SCAN;
+  eventPending = false;
+  perfTimerInit();
+}
+
+void perfRecord(uint8_t histogram, uint32_t cycles) {
+  Histogram& h = histograms[histogram];
+  if (resetMask & _BV(histogram)) {
+    resetMask &= ~_BV(histogram);
+    clearHistogram(h);
+  }
+  h.count++;
+  if (cycles < h.minCycles) h.minCycles = cycles;
+  if (cycles > h.maxCycles) h.maxCycles = cycles;
+  uint16_t& bucket = h.buckets[bucketOf(cycles)];
+  if (bucket != 0xFFFF) {
+    bucket++;
+  }
+}
+
+void perfMarkEvent(uint32_t start) {
+  if (!eventPending) {
+    eventStart = start;
+    eventPending = true;
+  }
+}
+
+void perfMarkReport() {
+  if (eventPending) {
+    eventPending = false;
+    perfRecord(PERF_LATENCY, perfNow() - eventStart);
+  }
+}
+
+void perfCancelEvent() {
+  eventPending = false;
+}
+
+void perfFillReport(PerfReport& report) {
+  const uint8_t index = selected;
+  const Histogram& h = histograms[index];
+  report.version = PERF_REPORT_VERSION;
+  report.histogram = index;
+  report.bucketShift = PERF_BUCKET_SHIFT;
+  report.bucketCount = PERF_BUCKETS;
+  if (resetMask & _BV(index)) {
+    memset(&report.count, 0, sizeof(report) - offsetof(PerfReport, count));
+    return;
+  }
+  report.count = h.count;
+  report.minCycles = h.count ? h.minCycles : 0;
+  report.maxCycles = h.maxCycles;
+  memcpy(report.buckets, h.buckets, sizeof(report.buckets));
+}
+
+void perfCommand(uint8_t cmd, uint8_t arg) {
+  if (cmd == PERF_CMD_SELECT && arg < PERF_HISTOGRAM_COUNT) {
+    selected = arg;
+  }
+  else if (cmd == PERF_CMD_RESET) {
+    resetMask |= (arg < PERF_HISTOGRAM_COUNT) ? _BV(arg) : (uint8_t)(_BV(PERF_HISTOGRAM_COUNT) - 1);
+  }
+}
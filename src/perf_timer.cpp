@@ -0,0 +1,34 @@
+//效能量測的時間戳
+//Timer1 以 16MHz 自由計數，溢位中斷補上高 16 位，perfNow() 即為 cycle 精度的時間戳。
+
+#include "perf.h"
+
+static volatile uint16_t timerHigh;
+
+ISR(TIMER1_OVF_vect) {
+  timerHigh++;
+}
+
+void perfTimerInit() {
+  timerHigh = 0;
+
+  //Timer1：一般模式、不分頻、開啟溢位中斷
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+  TCNT1 = 0;
+  TIFR1 = _BV(TOV1);
+  TIMSK1 |= _BV(TOIE1);
+}
+
+uint32_t perfNow() {
+  const uint8_t sreg = SREG;
+  cli();
+  const uint16_t low = TCNT1;
+  uint16_t high = timerHigh;
+  //溢位旗標已設但中斷尚未執行
+  if ((TIFR1 & _BV(TOV1)) && low < 0x8000) {
+    high++;
+  }
+  SREG = sreg;
+  return ((uint32_t)high << 16) | low;
+}
@@ -0,0 +1,153 @@
+//低功耗閒置
+
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include <util/atomic.h>
+#include "power.h"
+#include "config.h"
+#include "keyboard.h"
+#include "matrix.h"
+#include "encoder.h"
+#include "report.h"
+#include "scheduler.h"
+#include "eeprom_writer.h"
+#include "perf.h"
+#include "stats.h"
+
+#define WDT_PERIOD_MS 16  //看門狗不分頻的逾時（約值）
+#define CYCLES_PER_SECOND F_CPU
+
+static PowerStats totals;
+static uint32_t idleStart;
+static uint32_t deepSleepMs;    //本次閒置中 power-down 的估計時間（millis() 在 power-down 中不會前進）
+static uint32_t sleepCycles;    //IDLE 模式睡眠的 cycle 數，滿一秒換算進 totals.sleepMs
+static uint32_t wakeStart;
+static volatile bool wdtWoke;
+
+ISR(WDT_vect) {
+  wdtWoke = true;
+}
+
+void powerInit() {
+  memset(&totals, 0, sizeof(totals));
+  sleepCycles = 0;
+}
+
+bool powerIdleDue() {
+#if IDLE_TIMEOUT_MS
+  if (!keyboardQuiet()) {
+    return false;
+  }
+  //暫停中的回報要等主機恢復才送得出去，不必等它
+  if (USBDevice.isSuspended()) {
+    return true;
+  }
+  return !reportPending() && millis() - keyboardLastActivity() >= IDLE_TIMEOUT_MS;
+#else
+  return false;
+#endif
+}
+
+void powerEnter() {
+  schedulerPause();
+  matrixIdleArm();
+  idleStart = millis();
+  deepSleepMs = 0;
+  wakeStart = perfNow();
+  totals.idleCount++;
+}
+
+void powerExit() {
+  matrixIdleDisarm();
+  //USB 暫停中按下：請主機恢復（主機未允許遠端喚醒時不做任何事）
+  if (USBDevice.isSuspended() && USBDevice.wakeupHost()) {
+    totals.hostWakeups++;
+  }
+  totals.idleMs += millis() - idleStart + deepSleepMs;
+  telemetryDirty = true;
+
+  schedulerResume();
+  keyboardWake();
+  perfRecord(PERF_WAKE, perfNow() - wakeStart);
+}
+
+bool powerInputPending() {
+  //暫停中留下的回報：主機恢復後回到掃描把它送出
+  return matrixIdlePressed() || encoderMoved() || (reportPending() && !USBDevice.isSuspended());
+}
+
+//USB 正常：只停 CPU，任何中斷都會叫醒
+static void sleepIdle() {
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  cli();
+  if (powerInputPending()) {
+    sei();
+    return;
+  }
+  matrixIdleRearm();
+  const uint32_t start = perfNow();
+  sleep_enable();
+  sei();
+  sleep_cpu();
+  sleep_disable();
+  wakeStart = perfNow();
+  sleepCycles += wakeStart - start;
+  if (sleepCycles >= CYCLES_PER_SECOND) {
+    sleepCycles -= CYCLES_PER_SECOND;
+    totals.sleepMs += 1000;
+  }
+}
+
+//USB 暫停：依資料手冊的 suspend 流程凍結 USB 時脈並關 PLL，醒來時反過來恢復。
+//只被看門狗叫醒且沒有輸入時直接再睡，不恢復 USB 時脈。
+static void sleepPowerDown() {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    wdt_reset();
+    WDTCSR = _BV(WDCE) | _BV(WDE);
+    WDTCSR = _BV(WDIE);
+  }
+  USBCON |= _BV(FRZCLK);
+  PLLCSR &= ~_BV(PLLE);
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+
+  for (;;) {
+    cli();
+    if (powerInputPending() || !USBDevice.isSuspended()) {
+      sei();
+      break;
+    }
+    matrixIdleRearm();
+    wdtWoke = false;
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    if (!wdtWoke) {
+      break;
+    }
+    deepSleepMs += WDT_PERIOD_MS;
+    totals.sleepMs += WDT_PERIOD_MS;
+  }
+
+  //Timer1 在 power-down 中也會停，從這裡量起（不含振盪器起振時間）
+  wakeStart = perfNow();
+  wdt_disable();
+  PLLCSR |= _BV(PLLE);
+  while (!(PLLCSR & _BV(PLOCK))) {
+  }
+  USBCON &= ~_BV(FRZCLK);
+}
+
+void powerSleep() {
+  //EEPROM 寫入中（熱度表等）需要主迴圈繼續推進，只用 IDLE 模式
+  if (USBDevice.isSuspended() && !eepromWriterBusy()) {
+    sleepPowerDown();
+  }
+  else {
+    sleepIdle();
+  }
+}
+
+void powerGetStats(PowerStats& stats) {
+  stats = totals;
+}
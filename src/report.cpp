@@ -0,0 +1,212 @@
+//HID 回報組裝
+//鍵盤沿用 HID-Project 的 add()/remove()/send()，只在 flush 時送出，
+//依模式寫進 NKROKeyboard 或 BootKeyboard（兩者共用 KeyboardAPI 介面）；
+//滑鼠自行組回報，經自訂 HID 介面（usb_hid.cpp，含高解析度滾輪）送出。
+//同一個 frame 內先按下又放開的鍵，放開會延到下一份回報，避免整個按鍵被合併掉。
+
+#include <HID-Project.h>
+#include "config.h"
+#include "report.h"
+#include "usb_hid.h"
+#include "perf.h"
+
+static bool nkroEnabled;
+static KeyboardAPI* keyboard;
+static bool keyboardDirty;
+static bool mouseDirty;
+static uint8_t mouseButtons;
+static int32_t wheelPending;
+
+//鍵碼集合：每個鍵碼 1 bit，同時按下再多鍵也不會漏記
+typedef uint8_t codeset_t[32];
+
+static inline bool codeHas(const codeset_t set, uint8_t code) {
+  return set[code >> 3] & (1 << (code & 7));
+}
+
+static inline void codeSet(codeset_t set, uint8_t code, bool on) {
+  if (on) set[code >> 3] |= 1 << (code & 7);
+  else set[code >> 3] &= ~(1 << (code & 7));
+}
+
+//本 frame 新按下的鍵碼與滑鼠按鍵
+static codeset_t addedCodes;
+static bool addedAny;
+static uint8_t addedButtons;
+
+//延到下一份回報才放開的鍵碼與滑鼠按鍵
+static codeset_t deferredCodes;
+static bool deferredAny;
+static uint8_t deferredButtons;
+
+static uint8_t lastFrame;
+
+//目前按住的鍵碼（含延後放開的鍵），換鍵盤介面時複製過去
+static codeset_t heldCodes;
+
+//主機處於開機協定時只能用 6KRO 開機鍵盤
+static KeyboardAPI* activeKeyboard() {
+  if (nkroEnabled && BootKeyboard.getProtocol() != HID_BOOT_PROTOCOL) {
+    return &NKROKeyboard;
+  }
+  return &BootKeyboard;
+}
+
+//換到另一個鍵盤介面：舊介面的鍵全部放開，按住中的鍵改在新介面按下，
+//與 actions.cpp 的修飾鍵計數保持一致（開機鍵盤最多 6 個一般鍵，多的略過）
+static void selectKeyboard() {
+  KeyboardAPI* next = activeKeyboard();
+  if (next == keyboard) {
+    return;
+  }
+  keyboard->removeAll();
+  keyboard->send();
+  keyboard = next;
+  keyboard->removeAll();
+  for (uint16_t code = 0; code < 256; code++) {
+    if (codeHas(heldCodes, code)) {
+      keyboard->add((KeyboardKeycode)code);
+    }
+  }
+  keyboardDirty = true;
+}
+
+void reportBegin() {
+  nkroEnabled = OHK_NKRO_DEFAULT;
+  keyboard = activeKeyboard();
+  keyboardDirty = false;
+  mouseDirty = false;
+  mouseButtons = 0;
+  wheelPending = 0;
+  memset(addedCodes, 0, sizeof(addedCodes));
+  addedAny = false;
+  addedButtons = 0;
+  memset(deferredCodes, 0, sizeof(deferredCodes));
+  deferredAny = false;
+  deferredButtons = 0;
+  memset(heldCodes, 0, sizeof(heldCodes));
+  lastFrame = UDFNUML - 1;
+}
+
+void reportSetNkro(bool on) {
+  nkroEnabled = on;
+  selectKeyboard();
+}
+
+bool reportNkro() {
+  return nkroEnabled;
+}
+
+void reportKeyPress(uint8_t code) {
+  if (code == 0) {
+    return;
+  }
+  //主機切換協定（例如進入 BIOS）後的第一個按鍵改送到對應的介面
+  selectKeyboard();
+  keyboard->add((KeyboardKeycode)code);
+  codeSet(heldCodes, code, true);
+  codeSet(addedCodes, code, true);
+  addedAny = true;
+  //同一個 frame 內放開後又按下：取消延後的放開，否則下一份回報會把這次按下放掉
+  codeSet(deferredCodes, code, false);
+  keyboardDirty = true;
+}
+
+void reportKeyRelease(uint8_t code) {
+  if (code == 0) {
+    return;
+  }
+  if (codeHas(addedCodes, code)) {
+    codeSet(deferredCodes, code, true);
+    deferredAny = true;
+    return;
+  }
+  keyboard->remove((KeyboardKeycode)code);
+  codeSet(heldCodes, code, false);
+  keyboardDirty = true;
+}
+
+void reportReleaseAll() {
+  keyboard->removeAll();
+  memset(heldCodes, 0, sizeof(heldCodes));
+  memset(deferredCodes, 0, sizeof(deferredCodes));
+  deferredAny = false;
+  keyboardDirty = true;
+}
+
+void reportMousePress(uint8_t buttons) {
+  mouseButtons |= buttons;
+  addedButtons |= buttons;
+  deferredButtons &= ~buttons;
+  mouseDirty = true;
+}
+
+void reportMouseRelease(uint8_t buttons) {
+  deferredButtons |= buttons & addedButtons;
+  mouseButtons &= ~(buttons & ~addedButtons);
+  mouseDirty = true;
+}
+
+void reportMouseWheel(int16_t delta) {
+  wheelPending += delta;
+  mouseDirty = true;
+}
+
+bool reportPending() {
+  return keyboardDirty || mouseDirty;
+}
+
+void reportFlush() {
+  if (!keyboardDirty && !mouseDirty) {
+    //沒有產生回報的按鍵（空白鍵位等）不列入延遲統計
+    perfCancelEvent();
+    return;
+  }
+  //主機每個 frame 最多取走一份回報，同一個 frame 內的變化繼續累積；
+  //USB 暫停中不送：由 power.cpp 叫醒主機，恢復後閒置結束（powerInputPending）再送
+  const uint8_t frame = UDFNUML;
+  if (frame == lastFrame || USBDevice.isSuspended()) {
+    return;
+  }
+  lastFrame = frame;
+
+  if (keyboardDirty) {
+    keyboard->send();
+    keyboardDirty = false;
+  }
+  if (mouseDirty) {
+    UsbHidMouseReport report;
+    const int16_t wheel = (int16_t)constrain(wheelPending, -32767, 32767);
+    wheelPending -= wheel;
+    report.buttons = mouseButtons;
+    report.xAxis = 0;
+    report.yAxis = 0;
+    report.wheel = wheel;
+    UsbHid.sendReport(USB_HID_REPORTID_MOUSE, &report, sizeof(report));
+    mouseDirty = (wheelPending != 0);
+  }
+  if (addedAny) {
+    memset(addedCodes, 0, sizeof(addedCodes));
+    addedAny = false;
+  }
+  addedButtons = 0;
+  perfMarkReport();
+
+  //延後的放開在下一份回報送出
+  if (deferredAny) {
+    for (uint16_t code = 0; code < 256; code++) {
+      if (codeHas(deferredCodes, code)) {
+        keyboard->remove((KeyboardKeycode)code);
+        codeSet(heldCodes, code, false);
+        keyboardDirty = true;
+      }
+    }
+    memset(deferredCodes, 0, sizeof(deferredCodes));
+    deferredAny = false;
+  }
+  if (deferredButtons) {
+    mouseButtons &= ~deferredButtons;
+    deferredButtons = 0;
+    mouseDirty = true;
+  }
+}
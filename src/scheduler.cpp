@@ -0,0 +1,69 @@
+//固定頻率掃描排程
+//Timer3 在 CTC 模式下每次比對成功就歸零，因此讀 TCNT3 就是距離最近一次節拍的 cycle 數，
+//中斷只負責計數節拍，主迴圈比對計數即可知道是否錯過節拍。
+
+#include <util/atomic.h>
+#include "scheduler.h"
+#include "config.h"
+#include "perf.h"
+
+#define SCAN_PERIOD_CYCLES (F_CPU / SCAN_RATE_HZ)
+
+static_assert(SCAN_PERIOD_CYCLES - 1 <= 0xFFFF, "SCAN_RATE_HZ too low for an unscaled Timer3");
+
+static volatile uint16_t ticks;
+static uint16_t handled;
+
+ISR(TIMER3_COMPA_vect) {
+  ticks++;
+}
+
+void schedulerInit() {
+  ticks = 0;
+  handled = 0;
+
+  //Timer3：CTC（OCR3A 為上限）、不分頻、開啟比對中斷
+  TCCR3A = 0;
+  TCCR3B = _BV(WGM32) | _BV(CS30);
+  OCR3A = SCAN_PERIOD_CYCLES - 1;
+  TCNT3 = 0;
+  TIFR3 = _BV(OCF3A);
+  TIMSK3 |= _BV(OCIE3A);
+}
+
+bool schedulerTick() {
+  uint16_t now;
+  uint16_t sinceTick;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    sinceTick = TCNT3;
+    now = ticks;
+    //比對旗標已設但中斷尚未執行：TCNT3 已歸零，計數要補上
+    if (TIFR3 & _BV(OCF3A)) {
+      sinceTick = TCNT3;
+      now++;
+    }
+  }
+  if (now == handled) {
+    return false;
+  }
+  //掃描開始時距離應該掃描的節拍已經過多久；錯過的節拍各加一整個週期
+  const uint16_t missed = now - handled - 1;
+  handled = now;
+  perfRecord(PERF_JITTER, (uint32_t)missed * SCAN_PERIOD_CYCLES + sinceTick);
+  return true;
+}
+
+void schedulerPause() {
+  TIMSK3 &= ~_BV(OCIE3A);
+  TCCR3B &= ~_BV(CS30);
+}
+
+void schedulerResume() {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    TCNT3 = 0;
+    TIFR3 = _BV(OCF3A);
+    handled = ticks;
+  }
+  TCCR3B |= _BV(CS30);
+  TIMSK3 |= _BV(OCIE3A);
+}
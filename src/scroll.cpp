@@ -0,0 +1,68 @@
+//旋鈕滾動加速
+//以相鄰兩段的間隔估計轉速（段/秒，平滑後），換算成 Q8 倍率：
+//  慢速：1 倍（高解析度模式下低於 SCROLL_FINE_SPEED 為 SCROLL_FINE_GAIN，半格微調）
+//  快速：超過 SCROLL_ACCEL_START 後線性增加，上限 SCROLL_ACCEL_MAX
+//滾輪單位 = 段數 x 主機倍率 x 加速倍率，小數部分累積到下一次，不會遺失。
+
+#include "config.h"
+#include "scroll.h"
+#include "report.h"
+#include "usb_hid.h"
+
+//超過此時間沒有轉動，轉速歸零
+#define SCROLL_IDLE_MS 250
+
+static unsigned long lastDetentMs;
+static uint16_t speed;     //平滑後的轉速（段/秒）
+static int8_t lastDir;
+static int16_t residualQ8; //尚未送出的小數部分（Q8）
+
+static uint16_t gainQ8(uint8_t multiplier) {
+  if (speed <= SCROLL_ACCEL_START) {
+    if (multiplier > 1 && speed < SCROLL_FINE_SPEED) {
+      return SCROLL_FINE_GAIN;
+    }
+    return 256;
+  }
+  const uint32_t gain = 256 + (uint32_t)(speed - SCROLL_ACCEL_START) * SCROLL_ACCEL_SLOPE;
+  return (gain > SCROLL_ACCEL_MAX) ? SCROLL_ACCEL_MAX : (uint16_t)gain;
+}
+
+void scrollInit() {
+  lastDetentMs = 0;
+  speed = 0;
+  lastDir = 0;
+  residualQ8 = 0;
+}
+
+void scrollDetents(int8_t detents, unsigned long nowMs) {
+  if (detents == 0) {
+    return;
+  }
+  const int8_t dir = (detents > 0) ? 1 : -1;
+  const uint8_t count = (uint8_t)(detents * dir);
+
+  //換方向或停頓太久就重新估計轉速
+  const unsigned long dt = nowMs - lastDetentMs;
+  lastDetentMs = nowMs;
+  if (dir != lastDir || dt > SCROLL_IDLE_MS) {
+    speed = 0;
+    residualQ8 = 0;
+  }
+  else {
+    //每段平均間隔（至少 1ms），與前次轉速做 1:1 平滑
+    const uint16_t perDetent = (uint16_t)(dt / count);
+    const uint16_t instant = 1000 / (perDetent ? perDetent : 1);
+    speed = (uint16_t)((speed + instant) >> 1);
+  }
+  lastDir = dir;
+
+  const uint8_t multiplier = UsbHid.wheelMultiplier();
+  const int32_t unitsQ8 = (int32_t)count * multiplier * gainQ8(multiplier) + residualQ8;
+  const int16_t units = (int16_t)constrain(unitsQ8 >> 8, 0, 32767);
+  residualQ8 = (int16_t)(unitsQ8 & 0xFF);
+  if (units) {
+    //原本每段送出 -dir 格
+    reportMouseWheel((int16_t)(-dir * units));
+  }
+}
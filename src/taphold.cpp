@@ -0,0 +1,113 @@
+//點按 / 按住判定：待判定期間的事件放進小佇列，判定後依序重新派送
+
+#include "taphold.h"
+#include "actions.h"
+#include "layers.h"
+#include "config.h"
+
+#define TAP_HOLD_QUEUE 8  //待判定期間最多暫存的事件數，滿了直接判定為按住
+#define NO_KEY 0xFF
+
+struct QueuedEvent {
+  uint8_t keyID;
+  uint8_t pressed;
+  uint16_t timeMs;  //只用於重新派送時的待判定計時，16 位元足夠
+};
+
+static uint8_t pendingKey = NO_KEY;
+static uint16_t pendingSince;
+static QueuedEvent queue[TAP_HOLD_QUEUE];
+static uint8_t queueLen = 0;
+static uint32_t latestMs;  //收到過最新的時間，把 16 位元的時間還原成 32 位元
+
+static uint32_t fullTime(uint16_t timeMs) {
+  return latestMs - (uint16_t)((uint16_t)latestMs - timeMs);
+}
+
+static void process(byte keyID, bool pressed, uint16_t timeMs);
+
+//佇列中是否有這個鍵在待判定期間的按下
+static bool pressedWhilePending(byte keyID) {
+  for (uint8_t i = 0; i < queueLen; i++) {
+    if (queue[i].keyID == keyID && queue[i].pressed) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//送出待判定鍵的按下，再依原順序處理暫存的事件（其中可能又有新的待判定鍵）
+static void decide(bool hold) {
+  const byte keyID = pendingKey;
+  pendingKey = NO_KEY;
+  actionSetHold(keyID, hold);
+  actionDispatch(keyID, true, fullTime(pendingSince));
+
+  QueuedEvent events[TAP_HOLD_QUEUE];
+  const uint8_t count = queueLen;
+  memcpy(events, queue, count * sizeof(QueuedEvent));
+  queueLen = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    process(events[i].keyID, events[i].pressed, events[i].timeMs);
+  }
+}
+
+static void process(byte keyID, bool pressed, uint16_t timeMs) {
+  if (pendingKey == NO_KEY) {
+    if (pressed && actionIsTapHold(actionAt(layersResolve(keyID), keyID))) {
+      pendingKey = keyID;
+      pendingSince = timeMs;
+      return;
+    }
+    actionDispatch(keyID, pressed, fullTime(timeMs));
+    return;
+  }
+
+  //待判定前就按著的鍵放開時與判定無關，直接派送
+  if (!pressed && keyID != pendingKey && !pressedWhilePending(keyID)) {
+    actionDispatch(keyID, pressed, fullTime(timeMs));
+    return;
+  }
+
+  if (queueLen == TAP_HOLD_QUEUE) {
+    decide(true);
+    process(keyID, pressed, timeMs);
+    return;
+  }
+  queue[queueLen++] = { keyID, (uint8_t)pressed, timeMs };
+
+  //待判定鍵在時間內放開：點按（放開已在佇列尾端，依序送出）
+  if (keyID == pendingKey) {
+    decide(false);
+    return;
+  }
+#if OHK_TAP_HOLD == TAP_HOLD_OTHER_PRESS
+  if (pressed) {
+    decide(true);
+  }
+#elif OHK_TAP_HOLD == TAP_HOLD_PERMISSIVE
+  //最後一筆就是這次放開，前面有它的按下表示整個點按都發生在待判定期間
+  if (!pressed) {
+    decide(true);
+  }
+#endif
+}
+
+//組合鍵放行的按下帶著原本的時間，可能比已收到的事件早
+static void advance(uint32_t nowMs) {
+  if ((int32_t)(nowMs - latestMs) > 0) {
+    latestMs = nowMs;
+  }
+}
+
+void tapHoldEvent(byte keyID, bool pressed, uint32_t nowMs) {
+  advance(nowMs);
+  process(keyID, pressed, (uint16_t)nowMs);
+}
+
+void tapHoldUpdate(uint32_t nowMs) {
+  advance(nowMs);
+  if (pendingKey != NO_KEY && (uint16_t)((uint16_t)nowMs - pendingSince) >= TAPPING_TERM_MS) {
+    decide(true);
+  }
+}
@@ -0,0 +1,93 @@
+//HID 監控用狀態回報
+
+#include <util/atomic.h>
+#include "telemetry.h"
+#include "stats.h"
+#include "usb_hid.h"
+#include "perf.h"
+
+//最近一次送出的內容（Feature 報告讀取時回傳）
+static TelemetryReport lastSent;
+static unsigned long lastSentMs;
+
+void telemetryInit() {
+  memset(&lastSent, 0, sizeof(lastSent));
+  lastSent.version = TELEMETRY_VERSION;
+  //開機後第一份回報一定送出（所有欄位都視為有變化）
+  lastSent.currentLayer = 0xFF;
+  lastSentMs = 0;
+  telemetryDirty = true;
+}
+
+void telemetryUpdate(unsigned long nowMs) {
+  if (!telemetryDirty || (nowMs - lastSentMs) < TELEMETRY_MIN_INTERVAL_MS) {
+    return;
+  }
+  telemetryDirty = false;
+
+  TelemetryReport report;
+  memset(&report, 0, sizeof(report));
+  report.version = TELEMETRY_VERSION;
+  report.currentLayer = currentLayer;
+  report.lastKeyId = lastKeyId;
+  report.lastKeyLayer = lastKeyLayer;
+  report.keyPressCount = keyPressCount;
+  report.fnPressCount = fnPressCount;
+  report.encoderTurnCount = encoderTurnCount;
+  report.mouseClickCount = mouseClickCount;
+  memoryGetStats(report.memory);
+  powerGetStats(report.power);
+
+  uint8_t changed = 0;
+  if (report.currentLayer != lastSent.currentLayer) {
+    changed |= TELEMETRY_CHANGED_LAYER;
+  }
+  if (report.lastKeyId != lastSent.lastKeyId || report.lastKeyLayer != lastSent.lastKeyLayer) {
+    changed |= TELEMETRY_CHANGED_LAST_KEY;
+  }
+  if (report.keyPressCount != lastSent.keyPressCount) {
+    changed |= TELEMETRY_CHANGED_KEY_PRESS;
+  }
+  if (report.fnPressCount != lastSent.fnPressCount) {
+    changed |= TELEMETRY_CHANGED_FN_PRESS;
+  }
+  if (report.encoderTurnCount != lastSent.encoderTurnCount) {
+    changed |= TELEMETRY_CHANGED_ENCODER;
+  }
+  if (report.mouseClickCount != lastSent.mouseClickCount) {
+    changed |= TELEMETRY_CHANGED_MOUSE_CLICK;
+  }
+  if (memcmp(&report.memory, &lastSent.memory, sizeof(report.memory)) != 0) {
+    changed |= TELEMETRY_CHANGED_MEMORY;
+  }
+  if (memcmp(&report.power, &lastSent.power, sizeof(report.power)) != 0) {
+    changed |= TELEMETRY_CHANGED_POWER;
+  }
+  //標記了但內容沒變（例如按下空白鍵位）就不送
+  if (!changed) {
+    return;
+  }
+
+  report.seq = lastSent.seq + 1;
+  report.changed = changed;
+  report.uptimeMs = nowMs;
+
+  const uint32_t start = perfNow();
+  const int ret = UsbHid.sendReport(USB_HID_REPORTID_TELEMETRY, &report, sizeof(report));
+  perfRecord(PERF_TELEMETRY, perfNow() - start);
+  if (ret < 0) {
+    //主機未設定好等情況：保留標記，下次再送
+    telemetryDirty = true;
+    return;
+  }
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    lastSent = report;
+  }
+  lastSentMs = nowMs;
+}
+
+void telemetryFillReport(TelemetryReport& report) {
+  report = lastSent;
+  report.changed = TELEMETRY_CHANGED_ALL;
+}
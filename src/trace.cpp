@@ -0,0 +1,58 @@
+//除錯追蹤環形緩衝區
+//寫入端只在關中斷的幾個 cycle 內保留位置並複製 8 bytes，滿了就丟棄並計數；
+//讀出端在主迴圈中，只有主機打開序列埠且 CDC 有空間時才送出。
+
+#ifdef OHK_TRACE
+
+#include <util/atomic.h>
+#include "trace.h"
+
+//筆數需為 2 的次方
+#define TRACE_SIZE 32
+
+static TraceRecord ring[TRACE_SIZE];
+static volatile uint8_t head;
+static volatile uint8_t tail;
+static volatile uint16_t dropped;
+
+void traceWrite(uint8_t event, uint8_t keyID, uint8_t layer, uint16_t action) {
+  const uint16_t now = (uint16_t)millis();
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if ((uint8_t)(head - tail) >= TRACE_SIZE) {
+      dropped++;
+    }
+    else {
+      TraceRecord& rec = ring[head & (TRACE_SIZE - 1)];
+      rec.sync = TRACE_SYNC;
+      rec.event = event;
+      rec.keyID = keyID;
+      rec.layer = layer;
+      rec.action = action;
+      rec.timeMs = now;
+      head++;
+    }
+  }
+}
+
+void traceDrain() {
+  //沒有主機在聽時不送：緩衝區保留最早的紀錄，滿了之後新的紀錄丟棄並計數
+  if (!Serial.dtr()) {
+    return;
+  }
+
+  uint16_t lost;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    lost = dropped;
+    dropped = 0;
+  }
+  if (lost) {
+    traceWrite(TRACE_DROPPED, 0, 0, lost);
+  }
+
+  while (head != tail && Serial.availableForWrite() >= (int)sizeof(TraceRecord)) {
+    Serial.write((const uint8_t*)&ring[tail & (TRACE_SIZE - 1)], sizeof(TraceRecord));
+    tail++;
+  }
+}
+
+#endif
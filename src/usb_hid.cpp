@@ -0,0 +1,290 @@
+//自訂 HID 介面：高解析度滾輪滑鼠
+//寫法與 HID-Project 的 SingleReport 介面相同（一個 interrupt IN 端點），
+//另外處理 Feature 報告的 GET/SET_REPORT，讓主機讀寫 Resolution Multiplier
+//以及廠商集合中的效能直方圖、狀態回報、按鍵事件串流、熱度表與鍵位表。
+
+#include "usb_hid.h"
+#include "perf.h"
+#include "telemetry.h"
+#include "events.h"
+#include "heatmap.h"
+#include "keymap_store.h"
+#include "dynamics.h"
+
+static const uint8_t reportDescriptor[] PROGMEM = {
+  //滑鼠（報告 ID 1）：5 鍵、X/Y、16-bit 高解析度滾輪
+  0x05, 0x01,                    // USAGE_PAGE (Generic Desktop)
+  0x09, 0x02,                    // USAGE (Mouse)
+  0xa1, 0x01,                    // COLLECTION (Application)
+  0x85, USB_HID_REPORTID_MOUSE,  //   REPORT_ID
+  0x09, 0x01,                    //   USAGE (Pointer)
+  0xa1, 0x00,                    //   COLLECTION (Physical)
+  0x05, 0x09,                    //     USAGE_PAGE (Button)
+  0x19, 0x01,                    //     USAGE_MINIMUM (Button 1)
+  0x29, 0x05,                    //     USAGE_MAXIMUM (Button 5)
+  0x15, 0x00,                    //     LOGICAL_MINIMUM (0)
+  0x25, 0x01,                    //     LOGICAL_MAXIMUM (1)
+  0x95, 0x05,                    //     REPORT_COUNT (5)
+  0x75, 0x01,                    //     REPORT_SIZE (1)
+  0x81, 0x02,                    //     INPUT (Data,Var,Abs)
+  0x95, 0x01,                    //     REPORT_COUNT (1)
+  0x75, 0x03,                    //     REPORT_SIZE (3)
+  0x81, 0x03,                    //     INPUT (Cnst,Var,Abs)
+  0x05, 0x01,                    //     USAGE_PAGE (Generic Desktop)
+  0x09, 0x30,                    //     USAGE (X)
+  0x09, 0x31,                    //     USAGE (Y)
+  0x15, 0x81,                    //     LOGICAL_MINIMUM (-127)
+  0x25, 0x7f,                    //     LOGICAL_MAXIMUM (127)
+  0x75, 0x08,                    //     REPORT_SIZE (8)
+  0x95, 0x02,                    //     REPORT_COUNT (2)
+  0x81, 0x06,                    //     INPUT (Data,Var,Rel)
+  0xa1, 0x02,                    //     COLLECTION (Logical)
+  0x09, 0x48,                    //       USAGE (Resolution Multiplier)
+  0x15, 0x00,                    //       LOGICAL_MINIMUM (0)
+  0x25, 0x01,                    //       LOGICAL_MAXIMUM (1)
+  0x35, 0x01,                    //       PHYSICAL_MINIMUM (1)
+  0x45, USB_HID_WHEEL_MULTIPLIER,//       PHYSICAL_MAXIMUM
+  0x75, 0x02,                    //       REPORT_SIZE (2)
+  0x95, 0x01,                    //       REPORT_COUNT (1)
+  0xb1, 0x02,                    //       FEATURE (Data,Var,Abs)
+  0x35, 0x00,                    //       PHYSICAL_MINIMUM (0)
+  0x45, 0x00,                    //       PHYSICAL_MAXIMUM (0)
+  0x09, 0x38,                    //       USAGE (Wheel)
+  0x16, 0x01, 0x80,              //       LOGICAL_MINIMUM (-32767)
+  0x26, 0xff, 0x7f,              //       LOGICAL_MAXIMUM (32767)
+  0x75, 0x10,                    //       REPORT_SIZE (16)
+  0x95, 0x01,                    //       REPORT_COUNT (1)
+  0x81, 0x06,                    //       INPUT (Data,Var,Rel)
+  0xc0,                          //     END_COLLECTION
+  0x75, 0x06,                    //     REPORT_SIZE (6)
+  0x95, 0x01,                    //     REPORT_COUNT (1)
+  0xb1, 0x03,                    //     FEATURE (Cnst,Var,Abs)
+  0xc0,                          //   END_COLLECTION
+  0xc0,                          // END_COLLECTION
+
+  //廠商定義集合：效能直方圖（報告 ID 2，Feature）、狀態回報（報告 ID 3，Input / Feature）、
+  //按鍵事件（報告 ID 4，Input；Feature 為重送要求的起始序號）、熱度表（報告 ID 5，Feature）、
+  //鍵位表（報告 ID 6，Feature）、打字動態（報告 ID 7，Feature）
+  0x06, lowByte(USB_HID_VENDOR_USAGE_PAGE), highByte(USB_HID_VENDOR_USAGE_PAGE), // USAGE_PAGE (Vendor)
+  0x09, USB_HID_VENDOR_USAGE,    // USAGE
+  0xa1, 0x01,                    // COLLECTION (Application)
+  0x15, 0x00,                    //   LOGICAL_MINIMUM (0)
+  0x26, 0xff, 0x00,              //   LOGICAL_MAXIMUM (255)
+  0x75, 0x08,                    //   REPORT_SIZE (8)
+  0x85, USB_HID_REPORTID_PERF,   //   REPORT_ID
+  0x09, 0x02,                    //   USAGE (2)
+  0x95, sizeof(PerfReport),      //   REPORT_COUNT
+  0xb1, 0x02,                    //   FEATURE (Data,Var,Abs)
+  0x85, USB_HID_REPORTID_TELEMETRY, //   REPORT_ID
+  0x09, 0x03,                    //   USAGE (3)
+  0x95, sizeof(TelemetryReport), //   REPORT_COUNT
+  0x81, 0x02,                    //   INPUT (Data,Var,Abs)
+  0x09, 0x03,                    //   USAGE (3)
+  0xb1, 0x02,                    //   FEATURE (Data,Var,Abs)
+  0x85, USB_HID_REPORTID_EVENTS, //   REPORT_ID
+  0x09, 0x04,                    //   USAGE (4)
+  0x95, sizeof(EventReport),     //   REPORT_COUNT
+  0x81, 0x02,                    //   INPUT (Data,Var,Abs)
+  0x09, 0x04,                    //   USAGE (4)
+  0x95, 0x02,                    //   REPORT_COUNT (2)
+  0xb1, 0x02,                    //   FEATURE (Data,Var,Abs)
+  0x85, USB_HID_REPORTID_HEATMAP, //   REPORT_ID
+  0x09, 0x05,                    //   USAGE (5)
+  0x95, sizeof(HeatChunk),       //   REPORT_COUNT
+  0xb1, 0x02,                    //   FEATURE (Data,Var,Abs)
+  0x85, USB_HID_REPORTID_KEYMAP, //   REPORT_ID
+  0x09, 0x06,                    //   USAGE (6)
+  0x95, sizeof(KeymapReport),    //   REPORT_COUNT
+  0xb1, 0x02,                    //   FEATURE (Data,Var,Abs)
+  0x85, USB_HID_REPORTID_DYNAMICS, //   REPORT_ID
+  0x09, 0x07,                    //   USAGE (7)
+  0x95, sizeof(DynamicsChunk),   //   REPORT_COUNT
+  0xb1, 0x02,                    //   FEATURE (Data,Var,Abs)
+  0xc0,                          // END_COLLECTION
+};
+
+UsbHid_::UsbHid_() : PluggableUSBModule(1, 1, epType),
+  protocol(HID_REPORT_PROTOCOL), idle(1), resolution(0) {
+  epType[0] = EP_TYPE_INTERRUPT_IN;
+  PluggableUSB().plug(this);
+}
+
+int UsbHid_::getInterface(uint8_t* interfaceCount) {
+  *interfaceCount += 1;
+  HIDDescriptor hidInterface = {
+    D_INTERFACE(pluggedInterface, 1, USB_DEVICE_CLASS_HUMAN_INTERFACE, HID_SUBCLASS_NONE, HID_PROTOCOL_NONE),
+    D_HIDREPORT(sizeof(reportDescriptor)),
+    D_ENDPOINT(USB_ENDPOINT_IN(pluggedEndpoint), USB_ENDPOINT_TYPE_INTERRUPT, USB_EP_SIZE, 0x01)
+  };
+  return USB_SendControl(0, &hidInterface, sizeof(hidInterface));
+}
+
+int UsbHid_::getDescriptor(USBSetup& setup) {
+  if (setup.bmRequestType != REQUEST_DEVICETOHOST_STANDARD_INTERFACE) {
+    return 0;
+  }
+  if (setup.wValueH != HID_REPORT_DESCRIPTOR_TYPE) {
+    return 0;
+  }
+  if (setup.wIndex != pluggedInterface) {
+    return 0;
+  }
+
+  //重新列舉時回到預設狀態，由主機重新設定倍率
+  protocol = HID_REPORT_PROTOCOL;
+  resolution = 0;
+
+  return USB_SendControl(TRANSFER_PGM, reportDescriptor, sizeof(reportDescriptor));
+}
+
+bool UsbHid_::setup(USBSetup& setup) {
+  if (pluggedInterface != setup.wIndex) {
+    return false;
+  }
+
+  const uint8_t request = setup.bRequest;
+  const uint8_t requestType = setup.bmRequestType;
+
+  if (requestType == REQUEST_DEVICETOHOST_CLASS_INTERFACE) {
+    if (request == HID_GET_REPORT) {
+      if (setup.wValueH == HID_REPORT_TYPE_FEATURE && setup.wValueL == USB_HID_REPORTID_MOUSE) {
+        const uint8_t feature[2] = { USB_HID_REPORTID_MOUSE, resolution };
+        USB_SendControl(0, feature, sizeof(feature));
+      }
+      else if (setup.wValueH == HID_REPORT_TYPE_FEATURE && setup.wValueL == USB_HID_REPORTID_PERF) {
+        const uint8_t id = USB_HID_REPORTID_PERF;
+        PerfReport report;
+        perfFillReport(report);
+        USB_SendControl(0, &id, 1);
+        USB_SendControl(0, &report, sizeof(report));
+      }
+      else if (setup.wValueH == HID_REPORT_TYPE_FEATURE && setup.wValueL == USB_HID_REPORTID_TELEMETRY) {
+        //主機剛連上時讀一次完整內容，之後只收輸入報告
+        const uint8_t id = USB_HID_REPORTID_TELEMETRY;
+        TelemetryReport report;
+        telemetryFillReport(report);
+        USB_SendControl(0, &id, 1);
+        USB_SendControl(0, &report, sizeof(report));
+      }
+      else if (setup.wValueH == HID_REPORT_TYPE_FEATURE && setup.wValueL == USB_HID_REPORTID_HEATMAP) {
+        const uint8_t id = USB_HID_REPORTID_HEATMAP;
+        HeatChunk chunk;
+        heatFillChunk(chunk);
+        USB_SendControl(0, &id, 1);
+        USB_SendControl(0, &chunk, sizeof(chunk));
+      }
+      else if (setup.wValueH == HID_REPORT_TYPE_FEATURE && setup.wValueL == USB_HID_REPORTID_KEYMAP) {
+        const uint8_t id = USB_HID_REPORTID_KEYMAP;
+        KeymapReport report;
+        keymapFillReport(report);
+        USB_SendControl(0, &id, 1);
+        USB_SendControl(0, &report, sizeof(report));
+      }
+      else if (setup.wValueH == HID_REPORT_TYPE_FEATURE && setup.wValueL == USB_HID_REPORTID_DYNAMICS) {
+        const uint8_t id = USB_HID_REPORTID_DYNAMICS;
+        DynamicsChunk chunk;
+        dynamicsFillChunk(chunk);
+        USB_SendControl(0, &id, 1);
+        USB_SendControl(0, &chunk, sizeof(chunk));
+      }
+      else if (setup.wValueH == HID_REPORT_TYPE_FEATURE && setup.wValueL == USB_HID_REPORTID_EVENTS) {
+        //[報告 ID][下一份報告的起始序號（little-endian）]
+        const uint16_t seq = eventsSendStart();
+        const uint8_t feature[3] = { USB_HID_REPORTID_EVENTS, lowByte(seq), highByte(seq) };
+        USB_SendControl(0, feature, sizeof(feature));
+      }
+      else {
+        //沒有的報告：STALL，不回空的資料
+        return false;
+      }
+      return true;
+    }
+    if (request == HID_GET_PROTOCOL) {
+      USB_SendControl(0, &protocol, 1);
+      return true;
+    }
+    if (request == HID_GET_IDLE) {
+      USB_SendControl(0, &idle, 1);
+      return true;
+    }
+  }
+
+  if (requestType == REQUEST_HOSTTODEVICE_CLASS_INTERFACE) {
+    if (request == HID_SET_PROTOCOL) {
+      protocol = setup.wValueL;
+      return true;
+    }
+    if (request == HID_SET_IDLE) {
+      idle = setup.wValueL;
+      return true;
+    }
+    if (request == HID_SET_REPORT) {
+      if (setup.wValueH == HID_REPORT_TYPE_FEATURE && setup.wValueL == USB_HID_REPORTID_MOUSE
+          && setup.wLength == 2) {
+        uint8_t feature[2];
+        USB_RecvControl(feature, sizeof(feature));
+        resolution = feature[1] & 0x03;
+      }
+      else if (setup.wValueH == HID_REPORT_TYPE_FEATURE && setup.wValueL == USB_HID_REPORTID_PERF
+               && setup.wLength >= 3 && setup.wLength <= 1 + sizeof(PerfReport)) {
+        //命令：[報告 ID][命令][參數]，其餘補 0
+        uint8_t feature[1 + sizeof(PerfReport)];
+        USB_RecvControl(feature, setup.wLength);
+        perfCommand(feature[1], feature[2]);
+      }
+      else if (setup.wValueH == HID_REPORT_TYPE_FEATURE && setup.wValueL == USB_HID_REPORTID_EVENTS
+               && setup.wLength == 3) {
+        //[報告 ID][起始序號（little-endian）]
+        uint8_t feature[3];
+        USB_RecvControl(feature, sizeof(feature));
+        eventsRequestRetransmit(feature[1] | ((uint16_t)feature[2] << 8));
+      }
+      else if (setup.wValueH == HID_REPORT_TYPE_FEATURE && setup.wValueL == USB_HID_REPORTID_HEATMAP
+               && setup.wLength >= 4 && setup.wLength <= 1 + sizeof(HeatChunk)) {
+        //命令：[報告 ID][命令][參數（little-endian）]，其餘補 0
+        uint8_t feature[1 + sizeof(HeatChunk)];
+        USB_RecvControl(feature, setup.wLength);
+        heatCommand(feature[1], feature[2] | ((uint16_t)feature[3] << 8));
+      }
+      else if (setup.wValueH == HID_REPORT_TYPE_FEATURE && setup.wValueL == USB_HID_REPORTID_KEYMAP
+               && setup.wLength == 1 + sizeof(KeymapRequest)) {
+        uint8_t feature[1 + sizeof(KeymapRequest)];
+        USB_RecvControl(feature, sizeof(feature));
+        //上一個命令還沒處理完：回 STALL，主機重送
+        return keymapRequest(*(const KeymapRequest*)&feature[1]);
+      }
+      else if (setup.wValueH == HID_REPORT_TYPE_FEATURE && setup.wValueL == USB_HID_REPORTID_DYNAMICS
+               && setup.wLength >= 4 && setup.wLength <= 1 + sizeof(DynamicsChunk)) {
+        //命令：[報告 ID][命令][參數（little-endian）]，其餘補 0
+        uint8_t feature[1 + sizeof(DynamicsChunk)];
+        USB_RecvControl(feature, setup.wLength);
+        dynamicsCommand(feature[1], feature[2] | ((uint16_t)feature[3] << 8));
+      }
+      else {
+        return false;
+      }
+      return true;
+    }
+  }
+
+  return false;
+}
+
+int UsbHid_::sendReport(uint8_t id, const void* data, int len) {
+  //USB 暫停中不送：送出可能觸發遠端喚醒或卡住，只有按鍵（power.cpp 的 wakeupHost）會叫醒主機。
+  //呼叫端收到失敗會保留內容，主機恢復後再送
+  if (USBDevice.isSuspended()) {
+    return -1;
+  }
+  const int ret = USB_Send(pluggedEndpoint, &id, 1);
+  if (ret < 0) {
+    return ret;
+  }
+  const int ret2 = USB_Send(pluggedEndpoint | TRANSFER_RELEASE, data, len);
+  if (ret2 < 0) {
+    return ret2;
+  }
+  return ret + ret2;
+}
+
+UsbHid_ UsbHid;
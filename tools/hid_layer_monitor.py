@@ -4,6 +4,7 @@ import time
 import tkinter as tk
 from tkinter import ttk
 from tkinter import filedialog
+from tkinter import messagebox
 from collections import deque
 from datetime import datetime
 from pathlib import Path
@@ -31,9 +32,34 @@ if BACKEND is None:
         ) from exc
 
 
-REPORT_ID_GAMEPAD = 6
-USAGE_PAGE_GENERIC_DESKTOP = 0x01
-USAGE_JOYSTICK = 0x04
+USAGE_PAGE_VENDOR = 0xFF4B
+USAGE_VENDOR = 0x01
+REPORT_ID_PERF = 2
+REPORT_ID_TELEMETRY = 3
+TELEMETRY_VERSION = 3
+TELEMETRY_REPORT_SIZE = 63
+REPORT_ID_EVENTS = 4
+EVENTS_VERSION = 1
+EVENTS_REPORT_SIZE = 63
+EVENTS_PER_REPORT = 14
+EVENTS_FLAG_RESYNC = 0x01
+RETRANSMIT_INTERVAL = 0.2
+REPORT_ID_HEATMAP = 5
+HEAT_REPORT_SIZE = 63
+HEAT_CMD_SELECT = 1
+HEAT_CMD_FLUSH = 2
+HEAT_CMD_CLEAR = 3
+HEAT_OVERFLOW_COUNT = 16
+REPORT_ID_DYNAMICS = 7
+DYN_REPORT_SIZE = 63
+DYN_CMD_SELECT = 1
+DYN_CMD_CLEAR = 2
+DYN_BUCKETS = 16
+PERF_REPORT_SIZE = 48
+PERF_CMD_SELECT = 1
+PERF_CMD_RESET = 2
+PERF_HISTOGRAM_NAMES = ["掃描", "延遲", "掃描週期", "狀態回報", "掃描抖動", "閒置喚醒", "派送", "矩陣讀取"]
+CPU_HZ = 16_000_000
 APP_DIR = Path(os.getenv("APPDATA", ".")) / "OneHandKeyboard"
 SETTINGS_PATH = APP_DIR / "monitor_settings.json"
 LOG_DIR = APP_DIR / "logs"
@@ -49,10 +75,10 @@ KEYMAPS = [
         "LEFT", "RIGHT", "SPACE", "空", "空", "空", "空", "空",
     ],
     [
-        "空", "空", "空", "空", "空", "空", "空", "空",
+        "空", "空", "空", "空", "空", "空", "空", "功能",
         "LWIN", "F7", "F8", "F9", "F10", "F11", "F12", "空",
         "CAPS", "F1", "F2", "F3", "F4", "F5", "F6", "空",
-        "TAB", "空", "UP", "U", "I", "O", "P", "DELETE",
+        "TAB", "功能", "UP", "U", "I", "O", "P", "DELETE",
         "LSHIFT", "LEFT", "DOWN", "RIGHT", "J", "K", "L", "ENTER",
         "空", "空", "B", "N", "M", "空", "功能", "功能",
         "空", "空", "空", "空", "空", "空", "空", "空",
@@ -107,7 +133,7 @@ LAYER3_SPECIAL_LABELS = {
 }
 
 LAYER_SPECIAL_LABELS = {
-    1: {46: "WIN+SPACE"},
+    1: {7: "NKRO/6KRO", 25: "WIN+H", 46: "WIN+SPACE"},
     3: LAYER3_SPECIAL_LABELS,
 }
 
@@ -123,82 +149,237 @@ def get_key_label(layer, key_id):
 
 
 def parse_report(data):
-    if not data:
+    # 輸入報告：[ID][版本][序號][變化欄位][目前層][最近鍵][最近鍵所在層][5 個 u32]
+    #           [RAM：靜態、heap、堆疊最深、最少剩餘 4 個 u16]
+    #           [閒置：閒置 ms、睡眠 ms 2 個 u32，閒置次數、喚醒主機次數 2 個 u16][保留]
+    if not data or len(data) < 1 + TELEMETRY_REPORT_SIZE:
         return None
-
-    if len(data) >= 16 and data[0] == REPORT_ID_GAMEPAD:
-        payload = bytes(data[1:16])
-    elif len(data) >= 15:
-        payload = bytes(data[:15])
-    else:
+    if data[0] != REPORT_ID_TELEMETRY:
+        return None
+    payload = bytes(data[1 : 1 + TELEMETRY_REPORT_SIZE])
+    (
+        version,
+        seq,
+        changed,
+        current_layer,
+        last_key_id,
+        last_key_layer,
+        key_press,
+        fn_press,
+        encoder_turn,
+        mouse_click,
+        uptime_ms,
+        ram_static,
+        ram_heap,
+        ram_stack_peak,
+        ram_free_min,
+        idle_ms,
+        sleep_ms,
+        idle_count,
+        host_wakeups,
+    ) = struct.unpack("<BBBBBBIIIIIHHHHIIHH17x", payload)
+    if version != TELEMETRY_VERSION:
         return None
-
-    buttons, x, y, rx, ry, z, rz, dpads = struct.unpack("<IhhhhbbB", payload)
-    dpad1 = dpads & 0x0F
-    dpad2 = (dpads >> 4) & 0x0F
 
     return {
-        "buttons": buttons,
-        "key_press_count": x if x >= 0 else 0,
-        "fn_press_count": y if y >= 0 else 0,
-        "encoder_turn_count": rx if rx >= 0 else 0,
-        "mouse_click_count": ry if ry >= 0 else 0,
-        "current_layer": z if z >= 0 else 0,
-        "last_key_id": rz if rz >= 0 else 0,
-        "last_key_layer": dpad1 - 1 if dpad1 > 0 else None,
-        "current_layer_dpad": dpad2 - 1 if dpad2 > 0 else None,
+        "seq": seq,
+        "changed": changed,
+        "key_press_count": key_press,
+        "fn_press_count": fn_press,
+        "encoder_turn_count": encoder_turn,
+        "mouse_click_count": mouse_click,
+        "current_layer": current_layer,
+        "last_key_id": last_key_id,
+        "last_key_layer": last_key_layer,
+        "uptime_ms": uptime_ms,
+        "ram_static": ram_static,
+        "ram_heap": ram_heap,
+        "ram_stack_peak": ram_stack_peak,
+        "ram_free_min": ram_free_min,
+        "idle_ms": idle_ms,
+        "sleep_ms": sleep_ms,
+        "idle_count": idle_count,
+        "host_wakeups": host_wakeups,
     }
 
 
-class PyWinUsbDevice:
-    def __init__(self, device):
-        self.device = device
-        self.queue = []
-        self.lock = threading.Lock()
-        self.event = threading.Event()
+def parse_event_report(data):
+    # 輸入報告：[ID][版本][筆數][旗標][首筆序號 u16][下一個序號 u16][14 x (時間 u16, keyID, info)]
+    if not data or len(data) < 1 + EVENTS_REPORT_SIZE:
+        return None
+    if data[0] != REPORT_ID_EVENTS:
+        return None
+    payload = bytes(data[1 : 1 + EVENTS_REPORT_SIZE])
+    version, count, flags, first_seq, head_seq = struct.unpack_from("<BBBHH", payload)
+    if version != EVENTS_VERSION or count > EVENTS_PER_REPORT:
+        return None
+    events = []
+    for i in range(count):
+        time_ms, key_id, info = struct.unpack_from("<HBB", payload, 7 + i * 4)
+        events.append(
+            {
+                "seq": (first_seq + i) & 0xFFFF,
+                "time_ms": time_ms,
+                "key_id": key_id,
+                "pressed": bool(info & 0x80),
+                "layer": info & 0x0F,
+            }
+        )
+    return {"flags": flags, "first_seq": first_seq, "head_seq": head_seq, "events": events}
+
+
+class EventStream:
+    # 依序號接收事件：漏收時要求重送，重複的略過
+    def __init__(self):
+        self.expected = None
+        self.lost = 0
+        self.last_request = 0.0
+        self.time_base = 0
+        self.last_time16 = None
+
+    def _unwrap_time(self, time16):
+        # 韌體只送 millis() 低 16 位，依前後順序還原成連續的毫秒數；
+        # 判定後才送出的事件時間可能比前一筆稍早，差值以有號 16 位元解讀
+        if self.last_time16 is None:
+            self.time_base = time16
+        else:
+            delta = (time16 - self.last_time16) & 0xFFFF
+            if delta >= 0x8000:
+                delta -= 0x10000
+            self.time_base += delta
+        self.last_time16 = time16
+        return self.time_base
+
+    def accept(self, report):
+        """回傳 (新事件列表, 需要重送的起始序號或 None)"""
+        events = report["events"]
+        if not events:
+            return [], None
+        first = report["first_seq"]
+        if self.expected is None:
+            self.expected = first
+        if report["flags"] & EVENTS_FLAG_RESYNC:
+            # 要求的事件已被覆蓋，只能從韌體還留著的開始
+            gap = (first - self.expected) & 0xFFFF
+            if gap < 0x8000:
+                self.lost += gap
+                self.expected = first
+
+        accepted = []
+        for event in events:
+            diff = (event["seq"] - self.expected) & 0xFFFF
+            if diff == 0:
+                event["time_ms"] = self._unwrap_time(event["time_ms"])
+                accepted.append(event)
+                self.expected = (self.expected + 1) & 0xFFFF
+            elif diff < 0x8000:
+                # 中間有漏：丟掉這批之後的部分，等重送
+                now = time.time()
+                if now - self.last_request >= RETRANSMIT_INTERVAL:
+                    self.last_request = now
+                    return accepted, self.expected
+                return accepted, None
+        return accepted, None
+
+
+def read_device_heatmap(device):
+    # 依序讀出整張熱度表：[每個計數器低位 224 bytes][16 x (計數器編號, 高位 u16)]
+    raw = bytearray()
+    total = None
+    while total is None or len(raw) < total:
+        offset = len(raw)
+        send_feature(
+            device, REPORT_ID_HEATMAP, [HEAT_CMD_SELECT, offset & 0xFF, offset >> 8], HEAT_REPORT_SIZE
+        )
+        data = get_feature(device, REPORT_ID_HEATMAP, HEAT_REPORT_SIZE)
+        if not data or data[0] != REPORT_ID_HEATMAP:
+            return None
+        version, length, chunk_offset, total = struct.unpack_from("<BBHH", bytes(data), 1)
+        if version != 1 or chunk_offset != offset or length == 0:
+            return None
+        raw += bytes(data[7 : 7 + length])
+
+    counters = 4 * 56
+    counts = list(raw[:counters])
+    for i in range(HEAT_OVERFLOW_COUNT):
+        index, high = struct.unpack_from("<BH", raw, counters + i * 3)
+        if index < counters:
+            counts[index] += high << 8
+    return [counts[layer * 56 : (layer + 1) * 56] for layer in range(4)]
+
+
+def read_device_dynamics(device):
+    # 依序讀出整張打字動態表：[分格位移 x2][4 層按住時間][4 層間隔][每鍵平均按住時間 56 bytes]
+    # 每個直方圖為 [scale][16 格]，次數約為 格值 << scale
+    raw = bytearray()
+    total = None
+    wpm_x10 = 0
+    while total is None or len(raw) < total:
+        offset = len(raw)
+        send_feature(
+            device, REPORT_ID_DYNAMICS, [DYN_CMD_SELECT, offset & 0xFF, offset >> 8], DYN_REPORT_SIZE
+        )
+        data = get_feature(device, REPORT_ID_DYNAMICS, DYN_REPORT_SIZE)
+        if not data or data[0] != REPORT_ID_DYNAMICS:
+            return None
+        version, length, chunk_offset, total, wpm_x10 = struct.unpack_from("<BBHHH", bytes(data), 1)
+        if version != 1 or chunk_offset != offset or length == 0:
+            return None
+        raw += bytes(data[9 : 9 + length])
+
+    def histogram(pos):
+        scale = raw[pos]
+        return [count << scale for count in raw[pos + 1 : pos + 1 + DYN_BUCKETS]]
+
+    size = 1 + DYN_BUCKETS
+    return {
+        "wpm": wpm_x10 / 10,
+        "dwell_shift": raw[0],
+        "flight_shift": raw[1],
+        "dwell": [histogram(2 + layer * size) for layer in range(4)],
+        "flight": [histogram(2 + (4 + layer) * size) for layer in range(4)],
+        "key_dwell": list(raw[2 + 8 * size : 2 + 8 * size + 56]),
+    }
 
-    def open(self):
-        self.device.open()
-        self.device.set_raw_data_handler(self._handler)
 
-    def close(self):
-        try:
-            self.device.set_raw_data_handler(None)
-        except Exception:
-            pass
-        try:
-            self.device.close()
-        except Exception:
-            pass
+def parse_perf_report(data):
+    # Feature 報告：[ID][版本][編號][分格位移][格數][次數][最小][最大][16 格]
+    if not data or len(data) < 1 + PERF_REPORT_SIZE:
+        return None
+    if data[0] != REPORT_ID_PERF:
+        return None
+    payload = bytes(data[1 : 1 + PERF_REPORT_SIZE])
+    values = struct.unpack("<BBBBIII16H", payload)
+    version, histogram, shift, count_buckets, count, min_c, max_c = values[:7]
+    if version != 1:
+        return None
+    return {
+        "histogram": histogram,
+        "bucket_shift": shift,
+        "count": count,
+        "min_cycles": min_c,
+        "max_cycles": max_c,
+        "buckets": list(values[7 : 7 + count_buckets]),
+    }
 
-    def _handler(self, data):
-        with self.lock:
-            self.queue.append(data)
-            self.event.set()
 
-    def read(self, size, timeout_ms=200):
-        if not self.event.wait(timeout_ms / 1000.0):
-            return []
-        with self.lock:
-            data = self.queue.pop(0) if self.queue else []
-            if not self.queue:
-                self.event.clear()
-            return data
+def cycles_to_us(cycles):
+    return cycles * 1_000_000 / CPU_HZ
 
 
-def enumerate_gamepads():
+def enumerate_devices():
     devices = []
     if BACKEND == "hidapi":
         for dev in hid.enumerate():
-            if dev.get("usage_page") != USAGE_PAGE_GENERIC_DESKTOP:
+            if dev.get("usage_page") != USAGE_PAGE_VENDOR:
                 continue
-            if dev.get("usage") != USAGE_JOYSTICK:
+            if dev.get("usage") != USAGE_VENDOR:
                 continue
             dev["backend"] = "hidapi"
             devices.append(dev)
     else:
         for dev in win_hid.HidDeviceFilter(
-            usage_page=USAGE_PAGE_GENERIC_DESKTOP, usage=USAGE_JOYSTICK
+            usage_page=USAGE_PAGE_VENDOR, usage=USAGE_VENDOR
         ).get_devices():
             devices.append(
                 {
@@ -213,6 +394,17 @@ def enumerate_gamepads():
     return devices
 
 
+def send_feature(device, report_id, payload, size):
+    # Feature 報告固定長度，不足補 0
+    data = bytes([report_id]) + bytes(payload)
+    data = data + bytes(size + 1 - len(data))
+    device.send_feature_report(data)
+
+
+def get_feature(device, report_id, size):
+    return list(device.get_feature_report(report_id, size + 1))
+
+
 class HIDLayerMonitorApp:
     def __init__(self, root):
         self.root = root
@@ -226,6 +418,8 @@ class HIDLayerMonitorApp:
         self.last_layer = None
         self.toast_window = None
         self.recent_keys = deque(maxlen=10)
+        self.event_stream = EventStream()
+        self.pending_events = deque()
         self.last_key_press_count = None
         self.last_press_time = None
         self.press_history = deque()
@@ -233,16 +427,22 @@ class HIDLayerMonitorApp:
         self.logging_enabled = False
         self.csv_file = None
         self.json_file = None
+        self.events_file = None
         self.keymap_window = None
         self.heatmap_window = None
         self.heatmap_cells = []
         self.heatmap_canvas = None
+        self.perf_window = None
+        self.perf_canvas = None
+        self.dyn_window = None
+        self.dyn_canvas = None
         self.topmost_enabled = False
         self.auto_connect_enabled = True
         self.tray_enabled = False
         self.tray_icon = None
         self.per_key_counts = [0] * 56
         self.per_layer_counts = [[0] * 56 for _ in range(4)]
+        self.device_layer_counts = None
         self.session_rows = []
 
         self._build_ui()
@@ -301,6 +501,9 @@ class HIDLayerMonitorApp:
             "最近按鍵座標",
             "最近按鍵所在層",
             "平均按鍵速度",
+            "漏失事件",
+            "RAM",
+            "閒置",
         ]:
             ttk.Label(frame, text=label + "：", style="Label.TLabel").grid(
                 row=row, column=0, sticky="w"
@@ -333,19 +536,25 @@ class HIDLayerMonitorApp:
         ttk.Button(action_frame, text="熱度圖", command=self._open_heatmap_window).grid(
             row=0, column=3, padx=(0, 10)
         )
+        ttk.Button(action_frame, text="效能統計", command=self._open_perf_window).grid(
+            row=0, column=4, padx=(0, 10)
+        )
+        ttk.Button(action_frame, text="打字動態", command=self._open_dynamics_window).grid(
+            row=0, column=5, padx=(0, 10)
+        )
         self.log_button = ttk.Button(
             action_frame, text="開始記錄", command=self._toggle_logging
         )
-        self.log_button.grid(row=0, column=4, padx=(0, 10))
+        self.log_button.grid(row=0, column=6, padx=(0, 10))
         ttk.Button(
             action_frame, text="匯出 Excel", command=self._export_excel
-        ).grid(row=0, column=5, padx=(0, 10))
+        ).grid(row=0, column=7, padx=(0, 10))
         ttk.Button(
             action_frame, text="匯出熱度PNG", command=self._export_heatmap_png
-        ).grid(row=0, column=6, padx=(0, 10))
+        ).grid(row=0, column=8, padx=(0, 10))
         ttk.Button(
             action_frame, text="最小化到托盤", command=self._minimize_to_tray
-        ).grid(row=0, column=7)
+        ).grid(row=0, column=9)
         exit_btn = tk.Button(
             action_frame,
             text="退出",
@@ -359,7 +568,7 @@ class HIDLayerMonitorApp:
             padx=14,
             pady=6,
         )
-        exit_btn.grid(row=0, column=8, padx=(10, 0))
+        exit_btn.grid(row=0, column=9, padx=(10, 0))
 
         self.status = ttk.Label(frame, text="狀態：未連線", style="Label.TLabel")
         self.status.grid(row=row + 1, column=0, columnspan=4, sticky="w", pady=(8, 0))
@@ -462,6 +671,32 @@ class HIDLayerMonitorApp:
                 command=self._refresh_heatmap,
             ).pack(side="left", padx=4)
 
+        # 鍵盤累計：韌體保存在 EEPROM 的熱度表，App 沒開時的使用也會記錄
+        self.heatmap_source_var = tk.StringVar(value="session")
+        source_select = ttk.Frame(container)
+        source_select.pack(anchor="w", pady=(6, 0))
+        ttk.Label(source_select, text="來源：").pack(side="left")
+        ttk.Radiobutton(
+            source_select,
+            text="本次連線",
+            variable=self.heatmap_source_var,
+            value="session",
+            command=self._refresh_heatmap,
+        ).pack(side="left", padx=4)
+        ttk.Radiobutton(
+            source_select,
+            text="鍵盤累計",
+            variable=self.heatmap_source_var,
+            value="device",
+            command=self._refresh_heatmap,
+        ).pack(side="left", padx=4)
+        ttk.Button(source_select, text="從鍵盤讀取", command=self._load_device_heatmap).pack(
+            side="left", padx=(10, 4)
+        )
+        ttk.Button(source_select, text="清除鍵盤累計", command=self._clear_device_heatmap).pack(
+            side="left"
+        )
+
         canvas = tk.Canvas(container, width=520, height=360, bg="#1e1e1e")
         canvas.pack(fill="both", expand=True, pady=(6, 0))
         self.heatmap_canvas = canvas
@@ -498,6 +733,12 @@ class HIDLayerMonitorApp:
         per_layer_counts = self.per_key_counts if layer_index == 0 else None
         if hasattr(self, "per_layer_counts"):
             per_layer_counts = self.per_layer_counts[layer_index]
+        if (
+            getattr(self, "heatmap_source_var", None) is not None
+            and self.heatmap_source_var.get() == "device"
+            and self.device_layer_counts
+        ):
+            per_layer_counts = self.device_layer_counts[layer_index]
         if per_layer_counts is None:
             per_layer_counts = self.per_key_counts
         max_count = max(per_layer_counts) if per_layer_counts else 1
@@ -512,6 +753,239 @@ class HIDLayerMonitorApp:
                 self.heatmap_canvas.itemconfig(rect, fill=color)
                 self.heatmap_canvas.itemconfig(text, text=f"{key_id}\n{count}")
 
+    def _open_perf_window(self):
+        if self.perf_window and tk.Toplevel.winfo_exists(self.perf_window):
+            self.perf_window.lift()
+            return
+        self.perf_window = tk.Toplevel(self.root)
+        self.perf_window.title("效能統計（韌體端 cycle 直方圖）")
+        container = ttk.Frame(self.perf_window, padding=10)
+        container.pack(fill="both", expand=True)
+
+        self.perf_hist_var = tk.IntVar(value=0)
+        select = ttk.Frame(container)
+        select.pack(anchor="w")
+        ttk.Label(select, text="項目：").pack(side="left")
+        for i, name in enumerate(PERF_HISTOGRAM_NAMES):
+            ttk.Radiobutton(
+                select,
+                text=name,
+                variable=self.perf_hist_var,
+                value=i,
+                command=self._refresh_perf,
+            ).pack(side="left", padx=4)
+        ttk.Button(select, text="讀取", command=self._refresh_perf).pack(
+            side="left", padx=(10, 4)
+        )
+        ttk.Button(select, text="重置", command=self._reset_perf).pack(side="left")
+
+        self.perf_summary = ttk.Label(container, text="尚未讀取")
+        self.perf_summary.pack(anchor="w", pady=(6, 0))
+        self.perf_canvas = tk.Canvas(container, width=560, height=300, bg="#1e1e1e")
+        self.perf_canvas.pack(fill="both", expand=True, pady=(6, 0))
+        self._refresh_perf()
+
+    def _perf_request(self, cmd, arg, read):
+        if not self.device:
+            self.perf_summary.config(text="請先連線")
+            return None
+        try:
+            send_feature(self.device, REPORT_ID_PERF, [cmd, arg], PERF_REPORT_SIZE)
+            if not read:
+                return None
+            return parse_perf_report(
+                get_feature(self.device, REPORT_ID_PERF, PERF_REPORT_SIZE)
+            )
+        except Exception as exc:
+            self.perf_summary.config(text=f"讀取失敗（{exc}）")
+            return None
+
+    def _reset_perf(self):
+        self._perf_request(PERF_CMD_RESET, 0xFF, read=False)
+        self._refresh_perf()
+
+    def _refresh_perf(self):
+        if not self.perf_canvas:
+            return
+        histogram = int(self.perf_hist_var.get())
+        perf = self._perf_request(PERF_CMD_SELECT, histogram, read=True)
+        self.perf_canvas.delete("all")
+        if not perf:
+            return
+        if perf["count"] == 0:
+            self.perf_summary.config(text="次數 0")
+            return
+        self.perf_summary.config(
+            text=(
+                f"次數 {perf['count']}　"
+                f"最小 {cycles_to_us(perf['min_cycles']):.1f} us　"
+                f"最大 {cycles_to_us(perf['max_cycles']):.1f} us"
+            )
+        )
+        buckets = perf["buckets"]
+        peak = max(max(buckets), 1)
+        bar_w = 32
+        base_y = 270
+        for i, value in enumerate(buckets):
+            x0 = 12 + i * (bar_w + 2)
+            height = int(230 * value / peak)
+            self.perf_canvas.create_rectangle(
+                x0, base_y - height, x0 + bar_w, base_y, fill="#4f8ef7", outline=""
+            )
+            # 第 i 格下界為 2^(i+shift) cycle（第 0 格從 0 起）
+            lower = 0 if i == 0 else cycles_to_us(1 << (i + perf["bucket_shift"]))
+            label = f"{lower:.0f}" if lower >= 1 or i == 0 else f"{lower:.1f}"
+            self.perf_canvas.create_text(
+                x0 + bar_w // 2, base_y + 12, text=label, fill="#cfcfcf",
+                font=("Microsoft JhengHei", 8),
+            )
+            if value:
+                self.perf_canvas.create_text(
+                    x0 + bar_w // 2, base_y - height - 8, text=str(value),
+                    fill="#cfcfcf", font=("Microsoft JhengHei", 8),
+                )
+        self.perf_canvas.create_text(
+            548, base_y + 26, text="下界（us）", anchor="e", fill="#9a9a9a",
+            font=("Microsoft JhengHei", 8),
+        )
+
+    def _open_dynamics_window(self):
+        if self.dyn_window and tk.Toplevel.winfo_exists(self.dyn_window):
+            self.dyn_window.lift()
+            return
+        self.dyn_window = tk.Toplevel(self.root)
+        self.dyn_window.title("打字動態（按住時間 / 按鍵間隔 / WPM）")
+        container = ttk.Frame(self.dyn_window, padding=10)
+        container.pack(fill="both", expand=True)
+
+        self.dyn_layer_var = tk.IntVar(value=0)
+        select = ttk.Frame(container)
+        select.pack(anchor="w")
+        ttk.Label(select, text="Layer：").pack(side="left")
+        for layer in range(4):
+            ttk.Radiobutton(
+                select,
+                text=str(layer),
+                variable=self.dyn_layer_var,
+                value=layer,
+                command=self._refresh_dynamics,
+            ).pack(side="left", padx=4)
+        ttk.Button(select, text="讀取", command=self._refresh_dynamics).pack(
+            side="left", padx=(10, 4)
+        )
+        ttk.Button(select, text="重置", command=self._reset_dynamics).pack(side="left")
+
+        self.dyn_summary = ttk.Label(container, text="尚未讀取")
+        self.dyn_summary.pack(anchor="w", pady=(6, 0))
+        self.dyn_canvas = tk.Canvas(container, width=560, height=420, bg="#1e1e1e")
+        self.dyn_canvas.pack(fill="both", expand=True, pady=(6, 0))
+        self.dyn_keys = ttk.Label(container, text="", justify="left")
+        self.dyn_keys.pack(anchor="w", pady=(6, 0))
+        self._refresh_dynamics()
+
+    def _reset_dynamics(self):
+        if not self.device:
+            self.dyn_summary.config(text="請先連線")
+            return
+        try:
+            send_feature(self.device, REPORT_ID_DYNAMICS, [DYN_CMD_CLEAR, 0, 0], DYN_REPORT_SIZE)
+        except Exception as exc:
+            self.dyn_summary.config(text=f"重置失敗（{exc}）")
+            return
+        self._refresh_dynamics()
+
+    def _draw_dynamics_histogram(self, buckets, shift, top, title):
+        # 線性分格：第 i 格為 [i << shift, (i + 1) << shift) ms，最後一格含以上全部
+        peak = max(max(buckets), 1)
+        bar_w = 32
+        base_y = top + 170
+        self.dyn_canvas.create_text(
+            12, top + 4, text=title, anchor="w", fill="#e0e0e0",
+            font=("Microsoft JhengHei", 10),
+        )
+        for i, value in enumerate(buckets):
+            x0 = 12 + i * (bar_w + 2)
+            height = int(140 * value / peak)
+            self.dyn_canvas.create_rectangle(
+                x0, base_y - height, x0 + bar_w, base_y, fill="#4f8ef7", outline=""
+            )
+            self.dyn_canvas.create_text(
+                x0 + bar_w // 2, base_y + 12, text=str(i << shift), fill="#cfcfcf",
+                font=("Microsoft JhengHei", 8),
+            )
+            if value:
+                self.dyn_canvas.create_text(
+                    x0 + bar_w // 2, base_y - height - 8, text=str(value),
+                    fill="#cfcfcf", font=("Microsoft JhengHei", 8),
+                )
+
+    def _refresh_dynamics(self):
+        if not self.dyn_canvas:
+            return
+        if not self.device:
+            self.dyn_summary.config(text="請先連線")
+            return
+        try:
+            dyn = read_device_dynamics(self.device)
+        except Exception as exc:
+            self.dyn_summary.config(text=f"讀取失敗（{exc}）")
+            return
+        self.dyn_canvas.delete("all")
+        if not dyn:
+            self.dyn_summary.config(text="讀取失敗（韌體不支援或版本不符）")
+            return
+        layer = int(self.dyn_layer_var.get())
+        dwell = dyn["dwell"][layer]
+        flight = dyn["flight"][layer]
+        self.dyn_summary.config(
+            text=(
+                f"最近一分鐘 {dyn['wpm']:.1f} WPM　"
+                f"Layer {layer}：按住 {sum(dwell)} 次、間隔 {sum(flight)} 次"
+            )
+        )
+        self._draw_dynamics_histogram(dwell, dyn["dwell_shift"], 0, "按住時間（ms）")
+        self._draw_dynamics_histogram(flight, dyn["flight_shift"], 210, "按鍵間隔（上一次按下到這次按下，ms）")
+
+        slowest = sorted(
+            (ms, key_id) for key_id, ms in enumerate(dyn["key_dwell"]) if ms
+        )[::-1][:10]
+        self.dyn_keys.config(
+            text="平均按住最久："
+            + "、".join(f"{get_key_label(layer, key_id)} {ms}ms" for ms, key_id in slowest)
+            if slowest
+            else "平均按住最久：尚無資料"
+        )
+
+    def _load_device_heatmap(self):
+        if not self.device:
+            self.status.config(text="狀態：請先連線")
+            return
+        try:
+            counts = read_device_heatmap(self.device)
+        except Exception as exc:
+            self.status.config(text=f"狀態：讀取熱度表失敗（{exc}）")
+            return
+        if counts is None:
+            self.status.config(text="狀態：熱度表格式不符（請確認韌體版本）")
+            return
+        self.device_layer_counts = counts
+        self.heatmap_source_var.set("device")
+        self._refresh_heatmap()
+
+    def _clear_device_heatmap(self):
+        if not self.device:
+            self.status.config(text="狀態：請先連線")
+            return
+        if not messagebox.askyesno("清除鍵盤累計", "確定要清除鍵盤內保存的熱度統計嗎？"):
+            return
+        try:
+            send_feature(self.device, REPORT_ID_HEATMAP, [HEAT_CMD_CLEAR, 0, 0], HEAT_REPORT_SIZE)
+        except Exception as exc:
+            self.status.config(text=f"狀態：清除失敗（{exc}）")
+            return
+        self.device_layer_counts = [[0] * 56 for _ in range(4)]
+        self._refresh_heatmap()
+
     def _export_excel(self):
         try:
             import openpyxl # type: ignore
@@ -648,6 +1122,10 @@ class HIDLayerMonitorApp:
         json_path = LOG_DIR / f"telemetry_{timestamp}.jsonl"
         self.csv_file = open(csv_path, "a", encoding="utf-8", newline="")
         self.json_file = open(json_path, "a", encoding="utf-8")
+        # 事件串流另外記錄，可交給原生模擬重播（src/native/sim_main.cpp）
+        events_path = LOG_DIR / f"events_{timestamp}.csv"
+        self.events_file = open(events_path, "a", encoding="utf-8", newline="")
+        self.events_file.write("time_ms,key_id,pressed,layer\n")
         self.csv_file.write(
             "time,layer,key_press_count,fn_press_count,encoder_turn_count,mouse_click_count,last_key_id,last_key_label\n"
         )
@@ -660,8 +1138,11 @@ class HIDLayerMonitorApp:
             self.csv_file.close()
         if self.json_file:
             self.json_file.close()
+        if self.events_file:
+            self.events_file.close()
         self.csv_file = None
         self.json_file = None
+        self.events_file = None
         self.logging_enabled = False
         self.log_button.config(text="開始記錄")
 
@@ -704,7 +1185,7 @@ class HIDLayerMonitorApp:
         threading.Thread(target=self.tray_icon.run, daemon=True).start()
 
     def refresh_devices(self):
-        self.devices = enumerate_gamepads()
+        self.devices = enumerate_devices()
         values = []
         for idx, dev in enumerate(self.devices):
             product = dev.get("product_string") or "未知裝置"
@@ -738,6 +1219,15 @@ class HIDLayerMonitorApp:
                 self.device.open()
             else:
                 self.device = hid.Device(path=dev_info["path"])
+            # 狀態回報只在變化時送出，連線時先讀一次完整內容
+            try:
+                self.latest_data = parse_report(
+                    get_feature(self.device, REPORT_ID_TELEMETRY, TELEMETRY_REPORT_SIZE)
+                )
+            except Exception:
+                self.latest_data = None
+            self.event_stream = EventStream()
+            self.pending_events.clear()
             self.reader_running = True
             self.reader_thread = threading.Thread(
                 target=self.reader_loop, daemon=True
@@ -774,6 +1264,9 @@ class HIDLayerMonitorApp:
         while self.reader_running and self.device:
             try:
                 data = self.device.read(64, timeout_ms=200)
+                if data and data[0] == REPORT_ID_EVENTS:
+                    self._handle_event_report(data)
+                    continue
                 parsed = parse_report(data)
                 if parsed:
                     self.latest_data = parsed
@@ -781,6 +1274,46 @@ class HIDLayerMonitorApp:
                 self.latest_data = None
                 time.sleep(0.2)
 
+    def _handle_event_report(self, data):
+        report = parse_event_report(data)
+        if not report:
+            return
+        events, retransmit_from = self.event_stream.accept(report)
+        self.pending_events.extend(events)
+        if retransmit_from is not None:
+            send_feature(
+                self.device,
+                REPORT_ID_EVENTS,
+                [retransmit_from & 0xFF, retransmit_from >> 8],
+                2,
+            )
+
+    def _process_events(self):
+        # 按鍵紀錄與熱度圖以事件串流為準，打字再快也不會漏算
+        updated = False
+        while self.pending_events:
+            event = self.pending_events.popleft()
+            key_id = event["key_id"]
+            if self.logging_enabled and self.events_file:
+                self.events_file.write(
+                    f"{event['time_ms']},{key_id},{int(event['pressed'])},{event['layer']}\n"
+                )
+            if not event["pressed"] or not 0 <= key_id < len(self.per_key_counts):
+                continue
+            layer = event["layer"]
+            self.recent_keys.appendleft(f"{get_key_label(layer, key_id)} (L{layer})")
+            self.per_key_counts[key_id] += 1
+            if 0 <= layer < len(self.per_layer_counts):
+                self.per_layer_counts[layer][key_id] += 1
+            updated = True
+        if not updated:
+            return
+        self.recent_list.delete(0, tk.END)
+        for item in self.recent_keys:
+            self.recent_list.insert(tk.END, item)
+        if self.heatmap_window and tk.Toplevel.winfo_exists(self.heatmap_window):
+            self._refresh_heatmap()
+
     def _show_layer_toast(self, layer):
         # 顯示不干擾焦點的浮動提示
         if self.toast_window is not None:
@@ -825,6 +1358,7 @@ class HIDLayerMonitorApp:
         toast.after(1200, toast.destroy)
 
     def update_ui(self):
+        self._process_events()
         data = self.latest_data
         if data:
             current_layer = data["current_layer"]
@@ -851,6 +1385,19 @@ class HIDLayerMonitorApp:
             self.labels["最近按鍵所在層"].config(
                 text=str(last_key_layer) if last_key_layer is not None else "-"
             )
+            self.labels["漏失事件"].config(text=str(self.event_stream.lost))
+            self.labels["RAM"].config(
+                text=f"靜態 {data['ram_static']} B、堆疊最深 {data['ram_stack_peak']} B、"
+                f"最少剩餘 {data['ram_free_min']} B"
+                + (f"、heap {data['ram_heap']} B" if data["ram_heap"] else "")
+            )
+            uptime = max(data["uptime_ms"], 1)
+            self.labels["閒置"].config(
+                text=f"閒置 {data['idle_ms'] * 100 / uptime:.1f}%"
+                f"（睡眠 {data['sleep_ms'] * 100 / uptime:.1f}%）、"
+                f"{data['idle_count']} 次"
+                + (f"、喚醒主機 {data['host_wakeups']} 次" if data["host_wakeups"] else "")
+            )
 
             now = time.time()
             if self.last_key_press_count is None:
@@ -860,16 +1407,6 @@ class HIDLayerMonitorApp:
                 self.press_history.append((now, data["key_press_count"]))
                 self.last_key_press_count = data["key_press_count"]
                 self.last_press_time = now
-                self.recent_keys.appendleft(f"{key_label} (L{key_layer})")
-                self.recent_list.delete(0, tk.END)
-                for item in self.recent_keys:
-                    self.recent_list.insert(tk.END, item)
-                if 0 <= last_key_id < len(self.per_key_counts):
-                    self.per_key_counts[last_key_id] += 1
-                    if 0 <= key_layer < len(self.per_layer_counts):
-                        self.per_layer_counts[key_layer][last_key_id] += 1
-                if self.heatmap_window and tk.Toplevel.winfo_exists(self.heatmap_window):
-                    self._refresh_heatmap()
                 ts = datetime.now().isoformat(timespec="seconds")
                 self.session_rows.append(
                     [
@@ -0,0 +1,261 @@
+"""讀寫鍵盤 EEPROM 中的鍵位表（不需重新編譯韌體）。
+
+用法：
+  python tools/keymap_tool.py dump keymap.json      讀出目前鍵位表
+  python tools/keymap_tool.py upload keymap.json    上傳整張鍵位表並存入 EEPROM
+  python tools/keymap_tool.py set 1 25 0x080B       修改單一鍵位（層、keyID、動作碼）並存入 EEPROM
+  python tools/keymap_tool.py default               還原為韌體內建的鍵位表
+  python tools/keymap_tool.py revert                放棄尚未儲存的修改
+
+動作碼格式見 include/actions.h（bit 15..12 類型、11..8 參數、7..0 鍵碼）。
+"""
+
+import argparse
+import json
+import struct
+import sys
+import time
+
+BACKEND = None
+try:
+    import hid  # type: ignore
+
+    BACKEND = "hidapi"
+except Exception:
+    hid = None
+
+if BACKEND is None:
+    try:
+        import pywinusb.hid as win_hid  # type: ignore
+
+        BACKEND = "pywinusb"
+    except Exception as exc:
+        raise SystemExit(
+            "HID 函式庫載入失敗，請先安裝相依套件：\n"
+            "pip install -r tools/requirements.txt"
+        ) from exc
+
+
+USAGE_PAGE_VENDOR = 0xFF4B
+USAGE_VENDOR = 0x01
+REPORT_ID_KEYMAP = 6
+REPORT_SIZE = 63
+LAYER_COUNT = 4
+KEY_COUNT = 56
+CHUNK = 27
+
+CMD_READ = 1
+CMD_WRITE = 2
+CMD_COMMIT = 3
+CMD_DEFAULT = 4
+CMD_REVERT = 5
+
+STATUS_OK = 0
+STATUS_BUSY = 1
+STATUS_NAMES = {
+    0: "OK",
+    1: "忙碌",
+    2: "參數錯誤",
+    3: "CRC 不符（已還原）",
+    4: "唯讀（韌體以 OHK_KEYMAP_EDIT=0 編譯）",
+}
+
+SOURCE_DEFAULT = 0
+SOURCE_EEPROM = 1
+SOURCE_MODIFIED = 2
+SOURCE_NAMES = {0: "內建預設", 1: "EEPROM", 2: "已修改未儲存"}
+
+
+def crc16(data):
+    # 與韌體 _crc16_update 相同（多項式 0xA001，初值 0xFFFF）
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def keymap_crc(layers):
+    return crc16(b"".join(struct.pack(f"<{KEY_COUNT}H", *layer) for layer in layers))
+
+
+class KeymapDevice:
+    def __init__(self):
+        if BACKEND == "hidapi":
+            for dev in hid.enumerate():
+                if dev.get("usage_page") == USAGE_PAGE_VENDOR and dev.get("usage") == USAGE_VENDOR:
+                    self.device = hid.Device(path=dev["path"])
+                    return
+        else:
+            devices = win_hid.HidDeviceFilter(
+                usage_page=USAGE_PAGE_VENDOR, usage=USAGE_VENDOR
+            ).get_devices()
+            if devices:
+                self.device = devices[0]
+                self.device.open()
+                return
+        raise SystemExit("找不到鍵盤（請確認韌體版本與連線）")
+
+    def close(self):
+        self.device.close()
+
+    def _set(self, data):
+        if BACKEND == "hidapi":
+            return self.device.send_feature_report(data) >= 0
+        return self.device.send_feature_report(list(data))
+
+    def _get(self):
+        if BACKEND == "hidapi":
+            return bytes(self.device.get_feature_report(REPORT_ID_KEYMAP, REPORT_SIZE + 1))
+        for report in self.device.find_feature_reports():
+            if report.report_id == REPORT_ID_KEYMAP:
+                return bytes(report.get(do_process_raw_report=False))
+        return b""
+
+    def request(self, cmd, layer=0, start=0, count=0, crc=0, actions=()):
+        actions = list(actions) + [0] * (CHUNK - len(actions))
+        payload = struct.pack(f"<BBBBH{CHUNK}H3x", cmd, layer, start, count, crc, *actions)
+        data = bytes([REPORT_ID_KEYMAP]) + payload
+        # 韌體還在處理上一個命令時會拒收，稍等重送
+        for _ in range(50):
+            try:
+                if self._set(data):
+                    return
+            except Exception:
+                pass
+            time.sleep(0.005)
+        raise SystemExit("鍵盤沒有回應")
+
+    def report(self):
+        data = self._get()
+        if len(data) < 1 + REPORT_SIZE or data[0] != REPORT_ID_KEYMAP:
+            raise SystemExit("鍵位表報告格式不符（請確認韌體版本）")
+        values = struct.unpack(f"<BBBBBBH{CHUNK}H1x", data[1 : 1 + REPORT_SIZE])
+        version, status, source, layer, start, count, crc = values[:7]
+        if version != 1:
+            raise SystemExit(f"不支援的鍵位表報告版本 {version}")
+        return {
+            "status": status,
+            "source": source,
+            "layer": layer,
+            "start": start,
+            "count": count,
+            "crc": crc,
+            "actions": list(values[7 : 7 + count]),
+        }
+
+    def wait(self, timeout=2.0):
+        end = time.time() + timeout
+        while True:
+            rep = self.report()
+            if rep["status"] != STATUS_BUSY or time.time() > end:
+                return rep
+            time.sleep(0.005)
+
+    def read_all(self):
+        layers = []
+        for layer in range(LAYER_COUNT):
+            actions = []
+            for start in range(0, KEY_COUNT, CHUNK):
+                count = min(CHUNK, KEY_COUNT - start)
+                self.request(CMD_READ, layer, start, count)
+                actions += self.report()["actions"]
+            layers.append(actions)
+        return layers
+
+    def write_keys(self, layer, start, actions):
+        for offset in range(0, len(actions), CHUNK):
+            chunk = actions[offset : offset + CHUNK]
+            self.request(CMD_WRITE, layer, start + offset, len(chunk), actions=chunk)
+            rep = self.wait()
+            if rep["status"] != STATUS_OK:
+                raise SystemExit(f"寫入失敗：{STATUS_NAMES.get(rep['status'], rep['status'])}")
+
+    def commit(self, crc):
+        self.request(CMD_COMMIT, crc=crc)
+        rep = self.wait()
+        if rep["status"] != STATUS_OK:
+            raise SystemExit(f"儲存失敗：{STATUS_NAMES.get(rep['status'], rep['status'])}")
+        # 背景寫入 EEPROM 約需 1~2 秒
+        end = time.time() + 5.0
+        while rep["source"] != SOURCE_EEPROM and time.time() < end:
+            time.sleep(0.05)
+            rep = self.report()
+        if rep["source"] != SOURCE_EEPROM:
+            raise SystemExit("等待 EEPROM 寫入逾時")
+
+
+def parse_action(value):
+    if isinstance(value, int):
+        return value & 0xFFFF
+    return int(str(value), 0) & 0xFFFF
+
+
+def load_layers(path):
+    with open(path, "r", encoding="utf-8") as f:
+        data = json.load(f)
+    layers = [[parse_action(a) for a in layer] for layer in data["layers"]]
+    if len(layers) != LAYER_COUNT or any(len(layer) != KEY_COUNT for layer in layers):
+        raise SystemExit(f"鍵位表需為 {LAYER_COUNT} 層、每層 {KEY_COUNT} 個動作碼")
+    return layers
+
+
+def main():
+    parser = argparse.ArgumentParser(description="讀寫鍵盤 EEPROM 中的鍵位表")
+    sub = parser.add_subparsers(dest="command", required=True)
+    p = sub.add_parser("dump")
+    p.add_argument("file")
+    p = sub.add_parser("upload")
+    p.add_argument("file")
+    p = sub.add_parser("set")
+    p.add_argument("layer", type=int)
+    p.add_argument("key", type=int)
+    p.add_argument("action")
+    sub.add_parser("default")
+    sub.add_parser("revert")
+    args = parser.parse_args()
+
+    dev = KeymapDevice()
+    try:
+        if args.command == "dump":
+            layers = dev.read_all()
+            rep = dev.report()
+            with open(args.file, "w", encoding="utf-8") as f:
+                json.dump(
+                    {"layers": [[f"0x{a:04X}" for a in layer] for layer in layers]},
+                    f,
+                    indent=1,
+                )
+            print(f"已讀出（來源：{SOURCE_NAMES.get(rep['source'], rep['source'])}）")
+        elif args.command == "upload":
+            layers = load_layers(args.file)
+            start = time.time()
+            for layer, actions in enumerate(layers):
+                dev.write_keys(layer, 0, actions)
+            dev.commit(keymap_crc(layers))
+            print(f"已上傳並儲存（{(time.time() - start) * 1000:.0f} ms）")
+        elif args.command == "set":
+            if not 0 <= args.layer < LAYER_COUNT or not 0 <= args.key < KEY_COUNT:
+                raise SystemExit("層或 keyID 超出範圍")
+            # 先讀出整張表，在本機算出修改後的 CRC，與鍵盤端比對後才儲存
+            layers = dev.read_all()
+            action = parse_action(args.action)
+            layers[args.layer][args.key] = action
+            dev.write_keys(args.layer, args.key, [action])
+            dev.commit(keymap_crc(layers))
+            print("已修改並儲存")
+        elif args.command == "default":
+            dev.request(CMD_DEFAULT)
+            rep = dev.wait()
+            print(f"已還原為內建鍵位表（{STATUS_NAMES.get(rep['status'], rep['status'])}）")
+        elif args.command == "revert":
+            dev.request(CMD_REVERT)
+            rep = dev.wait()
+            print(f"目前來源：{SOURCE_NAMES.get(rep['source'], rep['source'])}")
+    finally:
+        dev.close()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,40 @@
+"""PlatformIO 建置後檢查：靜態 RAM（.data + .bss + .noinit）不得超過 custom_ram_budget。
+
+ATmega32U4 共 2560 bytes RAM，預算以外的部分留給堆疊與中斷；
+執行時實際的堆疊最深用量見 HID 監控工具的「RAM」欄位。
+在 platformio.ini 以 extra_scripts = post:tools/ram_budget.py 啟用。
+"""
+
+import subprocess
+import sys
+
+Import("env")  # noqa: F821  (PlatformIO 提供)
+
+SECTIONS = (".data", ".bss", ".noinit")
+
+
+def static_ram(elf, size_tool):
+    out = subprocess.check_output([size_tool, "-A", elf], text=True)
+    used = 0
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0] in SECTIONS:
+            used += int(fields[1])
+    return used
+
+
+def check_ram(source, target, env):
+    budget = int(env.GetProjectOption("custom_ram_budget", "0"))
+    if budget <= 0:
+        return
+    used = static_ram(str(target[0]), env.subst("$SIZETOOL"))
+    print(f"靜態 RAM：{used} / {budget} bytes（剩 {budget - used}）")
+    if used > budget:
+        sys.stderr.write(
+            f"錯誤：靜態 RAM 超出預算 {used - budget} bytes"
+            "（可用 -DOHK_KEYMAP_EDIT=0 讓鍵位表不佔 RAM）\n"
+        )
+        env.Exit(1)
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", check_ram)  # noqa: F821
@@ -0,0 +1,81 @@
+"""讀取 debug 韌體（-DOHK_TRACE）從序列埠送出的二進位追蹤紀錄並轉成文字。
+
+用法：python tools/trace_dump.py COM5
+"""
+
+import struct
+import sys
+
+try:
+    import serial  # type: ignore
+except Exception as exc:
+    raise SystemExit(
+        "序列埠函式庫載入失敗，請先安裝相依套件：\n"
+        "pip install -r tools/requirements.txt"
+    ) from exc
+
+
+TRACE_SYNC = 0xA5
+RECORD_SIZE = 8
+
+EVENT_NAMES = {
+    1: "按下",
+    2: "放開",
+    3: "切換層",
+    4: "遺失",
+}
+
+
+def parse_record(data):
+    sync, event, key_id, layer, action, time_ms = struct.unpack("<BBBBHH", data)
+    if sync != TRACE_SYNC:
+        return None
+    return {
+        "event": event,
+        "key_id": key_id,
+        "layer": layer,
+        "action": action,
+        "time_ms": time_ms,
+    }
+
+
+def format_record(rec):
+    name = EVENT_NAMES.get(rec["event"], f"未知({rec['event']})")
+    if rec["event"] == 3:
+        return f"{rec['time_ms']:>5} ms  {name}  Layer {rec['layer']}"
+    if rec["event"] == 4:
+        return f"{rec['time_ms']:>5} ms  {name}  {rec['action']} 筆"
+    return (
+        f"{rec['time_ms']:>5} ms  {name}  key {rec['key_id']:>2}  "
+        f"L{rec['layer']}  action 0x{rec['action']:04X}"
+    )
+
+
+def main():
+    if len(sys.argv) < 2:
+        raise SystemExit("用法：python tools/trace_dump.py <序列埠>")
+    port = serial.Serial(sys.argv[1], 115200, timeout=0.5)
+    port.dtr = True
+    buf = bytearray()
+    try:
+        while True:
+            buf += port.read(64)
+            # 以同步位元組對齊，遇到不完整或錯位的資料就往後找
+            while len(buf) >= RECORD_SIZE:
+                if buf[0] != TRACE_SYNC:
+                    del buf[0]
+                    continue
+                rec = parse_record(bytes(buf[:RECORD_SIZE]))
+                if rec is None:
+                    del buf[0]
+                    continue
+                del buf[:RECORD_SIZE]
+                print(format_record(rec), flush=True)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        port.close()
+
+
+if __name__ == "__main__":
+    main()